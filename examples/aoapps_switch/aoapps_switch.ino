@@ -28,7 +28,7 @@ This demo implements an application with two (dummy) apps.
 By pressing but A, the user can switch between the apps.
 The name of the active app is shown on the OLED.
 The green and red signaling LED show heart beat and error.
-App1 shows how to process button presses.
+App1 shows how to process button presses (events delivered by the manager).
 App2 goes into error after a while (to show that the green heart beat 
 LED stops and the red error LED switches on).
 
@@ -97,9 +97,8 @@ static aoresult_t app1_start() {
 }
 
 static aoresult_t app1_step() {
-  if( aoui32_but_wentdown(AOUI32_BUT_X) ) Serial.printf("app1: but X\n"); 
-  if( aoui32_but_wentdown(AOUI32_BUT_Y) ) Serial.printf("app1: but Y\n"); 
   if( millis()-last>2000 ) { Serial.printf("app1: step\n"); last=millis(); }
+  aoapps_mngr_wakeup_at(last+2001); // optional: tells manager when this app has work again
   return aoresult_ok;
 }
 
@@ -107,8 +106,10 @@ static void app1_stop() {
   Serial.printf("app1: stop\n\n");
 }
 
-void app1_register() {
-  aoapps_mngr_register("app1", "Application 1", "print X", "print Y", AOAPPS_MNGR_FLAGS_NONE, app1_start, app1_step, app1_stop, 0, 0);
+static aoresult_t app1_on_button(int but, int event) {
+  // The manager delivers X and Y events (press, repeat while held, release); this app only prints presses
+  if( event==AOAPPS_MNGR_BUTTON_PRESS ) Serial.printf("app1: but %s\n", but==AOUI32_BUT_X ? "X" : "Y" ); 
+  return aoresult_ok;
 }
 
 
@@ -134,19 +135,20 @@ static void app2_stop() {
   Serial.printf("app2: stop\n\n");
 }
 
-void app2_register() {
-  // Option: add flag AOAPPS_MNGR_FLAGS_NEXTONERR
-  aoapps_mngr_register("app2", "Application 2", "--", "--", AOAPPS_MNGR_FLAGS_NONE , app2_start, app2_step, app2_stop, 0, 0); 
-}
-
 
 // === application ==========================================================
 
 
+// The local apps; the table is checked at compile time and stored in flash
+AOAPPS_MNGR_TABLE( apps_table,
+  { "app1", "Application 1", "print X", "print Y", AOAPPS_MNGR_FLAGS_NONE, app1_start, app1_step, app1_stop, 0, 0, 0, 0, app1_on_button },
+  { "app2", "Application 2", "--"     , "--"     , AOAPPS_MNGR_FLAGS_NONE, app2_start, app2_step, app2_stop, 0, 0, 0, 0, 0 }, // Option: add flag AOAPPS_MNGR_FLAGS_NEXTONERR
+);
+
+
 // Pick apps that we want in this application (either from the aoapps library, or the local ones)
 void apps_register() {
-  app1_register();
-  app2_register();
+  aoapps_mngr_register_table(apps_table);
 }
 
 
@@ -176,6 +178,9 @@ void loop() {
 
   // Let current app progress
   aoapps_mngr_step();
+
+  // Sleep (yield) until the app manager has work again
+  delay( aoapps_mngr_idle_ms() );
 }
 
 
@@ -0,0 +1,84 @@
+// bench_chain.cpp - frame cost, app switch time and scaling to long chains, on the virtual chain
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <chrono>         // std::chrono
+#include <Arduino.h>      // millis()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_chain()
+
+
+// Host time (in us) since `start`
+static double bench_us(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double,std::micro>( std::chrono::steady_clock::now()-start ).count();
+}
+
+
+// Runs app `name` on a chain of `numnodes` nodes; prints bus load, host cost per step, and the switch time to dither
+static void bench_chain(int numnodes, int said, const char * name) {
+  sim_chain(numnodes, said);
+  aoapps_init();
+  aoapps_runled_register();
+  aoapps_dither_register();
+  aoapps_swflag_register();
+  aoapps_aniscript_register();
+  int appix= aoapps_mngr_app_find(name);
+  SIM_CHECK( appix>0 );
+  aoapps_mngr_start(appix);
+
+  // Let the manager build the topo map, and the app start
+  sim_run(1000 + numnodes*10);
+  SIM_CHECK( aoapps_mngr_app_running() && sim_chain_numinactive()==0 );
+
+  // Steady state: telegrams per second, wire utilization and host cost per step
+  uint32_t tx0= sim_tx;
+  auto start= std::chrono::steady_clock::now();
+  uint32_t steps= sim_run(5000);
+  double hostus= bench_us(start);
+  uint32_t txps= (sim_tx-tx0)/5;
+  
+  // Switch to dither (keeps the topo map): virtual time until dither runs
+  uint64_t t0= sim_us;
+  uint32_t tx1= sim_tx;
+  sim_cmd("@apps switch dither");
+  while( !aoapps_mngr_app_running() ) { aoapps_mngr_step(); delay( aoapps_mngr_idle_ms() ); }
+  uint32_t switchus= sim_us-t0;
+  
+  printf("%-9s %-4s %5d %5d  %8lu %5.1f%%  %8.2f  %8.2f %6lu\n", name, said?"said":"rgbi", numnodes, aomw_topo_numtriplets(), 
+    (unsigned long)txps, txps*sim_tel_us/10000.0, hostus/steps, switchus/1000.0, (unsigned long)(sim_tx-tx1) );
+  aoapps_mngr_stop();
+}
+
+
+int main() {
+  aoapps_mngr_cmd_register();
+  sim_serial_capture(1); // discard app messages
+  printf("telegram wire time %lu us\n", (unsigned long)sim_tel_us);
+  printf("%-9s %-4s %5s %5s  %8s %6s  %8s  %8s %6s\n", "app", "node", "nodes", "trip", "tel/s", "wire", "us/step", "switchms", "tel");
+  const char * apps[]= { "runled", "swflag", "aniscript" };
+  const int sizes[]= { 10, 100, 1000 };
+  for( const char * app : apps ) 
+    for( int said=0; said<=1; said++ ) 
+      for( int numnodes : sizes ) 
+        bench_chain(numnodes, said, app);
+  printf("tel/s and wire: telegrams per second in steady state, and the share of wire time they take\n");
+  printf("us/step: host time per aoapps_mngr_step() (includes the simulation)\n");
+  printf("switchms and tel: virtual time and telegrams of 'apps switch dither' until dither runs\n");
+  return sim_report("bench_chain");
+}
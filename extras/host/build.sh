@@ -0,0 +1,28 @@
+#!/bin/sh
+# build.sh - builds aoapps on a workstation, against the stand-ins in stubs/ and the virtual chain in sim.cpp,
+# then builds and runs the tests and benchmarks (all test_*.cpp and bench_*.cpp, or the ones named as arguments).
+# Usage:  extras/host/build.sh [test_xxx|bench_xxx ...]
+# Needs a C++17 compiler with std::thread (set CXX/CXXFLAGS to override); output goes to extras/host/build/.
+set -e
+HOST=$(cd "$(dirname "$0")" && pwd)
+SRC="$HOST/../../src"
+OUT="$HOST/build"
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=gnu++17 -O2 -g -Wall -Wextra -Wno-unused-parameter}
+INCS="-I$HOST/stubs -I$SRC -I$HOST"
+
+mkdir -p "$OUT/lib"
+for f in "$SRC"/*.cpp "$HOST"/sim.cpp; do
+  $CXX $CXXFLAGS $INCS -c "$f" -o "$OUT/lib/$(basename "$f" .cpp).o"
+done
+
+NAMES=${*:-$(cd "$HOST" && ls test_*.cpp bench_*.cpp 2>/dev/null | sed 's/\.cpp$//')}
+FAILED=""
+for name in $NAMES; do
+  $CXX $CXXFLAGS $INCS -pthread "$HOST/$name.cpp" "$OUT"/lib/*.o -o "$OUT/$name"
+  echo "=== $name"
+  "$OUT/$name" || FAILED="$FAILED $name"
+done
+
+if [ -n "$FAILED" ]; then echo "FAILED:$FAILED"; exit 1; fi
+echo "all passed"
@@ -0,0 +1,481 @@
+// sim.cpp - virtual OSP chain and host stand-ins, so that aoapps runs (and can be profiled) on a workstation
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdlib.h>       // abort()
+#include <unistd.h>       // _exit()
+#include <deque>          // std::deque
+#include <mutex>          // std::mutex
+#include <thread>         // std::thread
+#include <vector>         // std::vector
+#include <Arduino.h>      // millis()
+#include <aoresult.h>     // aoresult_t
+#include <aospi.h>        // aospi_txcount_get()
+#include <aoosp.h>        // aoosp_send_readstat()
+#include <aomw.h>         // aomw_topo_settriplet()
+#include <aoui32.h>       // aoui32_but_scan()
+#include <aocmd.h>        // aocmd_cint_register()
+#include <aoapps.h>       // aoapps_mngr_step()
+#include "sim.h"          // own
+
+
+// === time ==================================================================
+
+
+std::atomic<uint64_t> sim_us;
+uint32_t sim_tel_us= 20;
+
+
+uint32_t millis() { return (uint32_t)( sim_us / 1000 ); }
+uint32_t micros() { return (uint32_t)( sim_us += 1 ); }
+void     delay(uint32_t ms) { sim_us += (uint64_t)ms * 1000; }
+
+
+// === Serial ================================================================
+
+
+HostSerial Serial;
+static std::mutex           sim_serial_mutex;
+static std::deque<uint8_t>  sim_serial_in;
+static std::vector<uint8_t> sim_serial_out;
+static int                  sim_serial_capturing;
+
+
+// Sends `size` bytes to stdout, or to the capture buffer
+static size_t sim_serial_out_append(const uint8_t * buf, size_t size) {
+  std::lock_guard<std::mutex> lock(sim_serial_mutex);
+  if( sim_serial_capturing ) sim_serial_out.insert(sim_serial_out.end(), buf, buf+size);
+  else fwrite(buf, 1, size, stdout);
+  return size;
+}
+
+
+int HostSerial::printf(const char * format, ...) {
+  char buf[512];
+  va_list args;
+  va_start(args, format);
+  int size= vsnprintf(buf, sizeof buf, format, args);
+  va_end(args);
+  if( size>(int)sizeof(buf)-1 ) size= sizeof(buf)-1;
+  return sim_serial_out_append((const uint8_t *)buf, size);
+}
+size_t HostSerial::write(uint8_t byte) { return sim_serial_out_append(&byte, 1); }
+size_t HostSerial::write(const uint8_t * buf, size_t size) { return sim_serial_out_append(buf, size); }
+int HostSerial::available() { std::lock_guard<std::mutex> lock(sim_serial_mutex); return sim_serial_in.size(); }
+int HostSerial::peek() { std::lock_guard<std::mutex> lock(sim_serial_mutex); return sim_serial_in.empty() ? -1 : sim_serial_in.front(); }
+int HostSerial::read() { 
+  std::lock_guard<std::mutex> lock(sim_serial_mutex); 
+  if( sim_serial_in.empty() ) return -1;
+  int byte= sim_serial_in.front();
+  sim_serial_in.pop_front();
+  return byte;
+}
+
+
+void sim_serial_feed(const uint8_t * buf, int size) {
+  std::lock_guard<std::mutex> lock(sim_serial_mutex);
+  sim_serial_in.insert(sim_serial_in.end(), buf, buf+size);
+}
+
+
+void sim_serial_feedstr(const char * str) {
+  sim_serial_feed((const uint8_t *)str, strlen(str));
+}
+
+
+void sim_serial_capture(int enable) {
+  std::lock_guard<std::mutex> lock(sim_serial_mutex);
+  sim_serial_capturing= enable;
+}
+
+
+int sim_serial_captured(uint8_t * buf, int size) {
+  std::lock_guard<std::mutex> lock(sim_serial_mutex);
+  int count= (int)sim_serial_out.size() < size ? (int)sim_serial_out.size() : size;
+  memcpy(buf, sim_serial_out.data(), count);
+  sim_serial_out.erase(sim_serial_out.begin(), sim_serial_out.begin()+count);
+  return count;
+}
+
+
+// === FreeRTOS ==============================================================
+
+
+static thread_local TaskHandle_t sim_task_current;
+static int                       sim_task_token;
+static int                       sim_task_started;
+
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t func, const char * name, uint32_t stack, void * param, int prio, TaskHandle_t * handle, int core) {
+  TaskHandle_t task= &sim_task_token;
+  *handle= task; // before the task runs, like FreeRTOS
+  sim_task_started= 1;
+  std::thread( [=]{ sim_task_current= task; func(param); } ).detach();
+  return pdPASS;
+}
+TaskHandle_t xTaskGetCurrentTaskHandle() { return sim_task_current; }
+void vTaskDelay(uint32_t ticks) { sim_us += (uint64_t)ticks * 1000; std::this_thread::yield(); }
+
+
+// === aoresult ==============================================================
+
+
+const char * aoresult_to_str(aoresult_t result, int upper) {
+  static const char * names[]= { "ok", "other", "outofmem", "sys_arg", "spi_noclock", "dev_noi2cdev" };
+  return result<(int)(sizeof names/sizeof names[0]) ? names[result] : "unknown";
+}
+
+
+void aoresult_assert(const char * cond, const char * file, int line) {
+  fflush(stdout);
+  fprintf(stderr, "ASSERT FAILED: %s (%s:%d)\n", cond, file, line);
+  abort();
+}
+
+
+// === chain =================================================================
+
+
+static std::vector<uint8_t> sim_chain_stat; // status byte per node (only the state field is modeled)
+static int      sim_chain_said;             // all nodes are SAIDs (else RGBIs)
+static int      sim_chain_dim= 1024;        // topo dim level
+uint32_t sim_tx, sim_rx, sim_settriplets, sim_identifies, sim_readstats, sim_unicasts, sim_broadcasts, sim_frames;
+
+
+// One telegram on the wire (with response when `rx`)
+static void sim_tel(int rx) {
+  sim_us += sim_tel_us;
+  sim_tx++;
+  if( rx ) sim_rx++;
+}
+
+
+static int sim_chain_numnodes() { return (int)sim_chain_stat.size(); }
+
+
+void sim_chain(int numnodes, int said) {
+  sim_chain_stat.assign(numnodes, AOOSP_STAT_STATE_UNINIT);
+  sim_chain_said= said;
+  sim_tx= sim_rx= sim_settriplets= sim_identifies= sim_readstats= sim_unicasts= sim_broadcasts= sim_frames= 0;
+}
+
+
+void sim_chain_sleepall() {
+  for( uint8_t & stat : sim_chain_stat ) stat= AOOSP_STAT_STATE_SLEEP;
+}
+
+
+void sim_chain_sleep(uint16_t addr) {
+  if( addr>=1 && addr<=sim_chain_numnodes() ) sim_chain_stat[addr-1]= AOOSP_STAT_STATE_SLEEP;
+}
+
+
+int sim_chain_numinactive() {
+  int count= 0;
+  for( uint8_t stat : sim_chain_stat ) if( stat!=AOOSP_STAT_STATE_ACTIVE ) count++;
+  return count;
+}
+
+
+// === aospi =================================================================
+
+
+static uint32_t sim_aospi_tx0, sim_aospi_rx0;
+void     aospi_init() { }
+void     aospi_txcount_reset() { sim_aospi_tx0= sim_tx; }
+uint32_t aospi_txcount_get() { return sim_tx-sim_aospi_tx0; }
+void     aospi_rxcount_reset() { sim_aospi_rx0= sim_rx; }
+uint32_t aospi_rxcount_get() { return sim_rx-sim_aospi_rx0; }
+
+
+// === aoosp =================================================================
+
+
+void aoosp_init() { }
+
+
+aoresult_t aoosp_send_clrerror(uint16_t addr) { 
+  sim_tel(0); 
+  if( addr==0 ) sim_broadcasts++; else sim_unicasts++;
+  return aoresult_ok; 
+}
+
+
+aoresult_t aoosp_send_goactive(uint16_t addr) { 
+  sim_tel(0); 
+  if( addr==0 ) sim_broadcasts++; else sim_unicasts++;
+  for( int ix=0; ix<sim_chain_numnodes(); ix++ ) 
+    if( (addr==0 || addr==ix+1) && sim_chain_stat[ix]==AOOSP_STAT_STATE_SLEEP ) sim_chain_stat[ix]= AOOSP_STAT_STATE_ACTIVE;
+  return aoresult_ok; 
+}
+
+
+aoresult_t aoosp_send_readstat(uint16_t addr, uint8_t * stat) {
+  sim_tel(1);
+  sim_readstats++;
+  if( addr<1 || addr>sim_chain_numnodes() ) return aoresult_spi_noclock;
+  *stat= sim_chain_stat[addr-1];
+  return aoresult_ok;
+}
+
+
+aoresult_t aoosp_send_identify(uint16_t addr, uint32_t * id) {
+  sim_tel(1);
+  sim_identifies++;
+  if( addr<1 || addr>sim_chain_numnodes() ) return aoresult_spi_noclock;
+  *id= aomw_topo_node_id(addr);
+  return aoresult_ok;
+}
+
+
+aoresult_t aoosp_send_setpwm(uint16_t addr, uint16_t red, uint16_t green, uint16_t blue, uint8_t daytimes) { sim_tel(0); return aoresult_ok; }
+aoresult_t aoosp_send_readpwm(uint16_t addr, uint16_t * red, uint16_t * green, uint16_t * blue, uint8_t * daytimes) { sim_tel(1); *red= *green= *blue= 1; *daytimes= 0; return aoresult_ok; }
+aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16_t green, uint16_t blue) { sim_tel(0); return aoresult_ok; }
+aoresult_t aoosp_send_readpwmchn(uint16_t addr, uint8_t chn, uint16_t * red, uint16_t * green, uint16_t * blue) { sim_tel(1); *red= *green= *blue= 1; return aoresult_ok; }
+
+
+// === aomw topo =============================================================
+
+
+const aomw_topo_rgb_t aomw_topo_red    = { 0x7FFF, 0x0000, 0x0000, "red"     };
+const aomw_topo_rgb_t aomw_topo_yellow = { 0x7FFF, 0x7FFF, 0x0000, "yellow"  };
+const aomw_topo_rgb_t aomw_topo_green  = { 0x0000, 0x7FFF, 0x0000, "green"   };
+const aomw_topo_rgb_t aomw_topo_cyan   = { 0x0000, 0x7FFF, 0x7FFF, "cyan"    };
+const aomw_topo_rgb_t aomw_topo_magenta= { 0x7FFF, 0x0000, 0x7FFF, "magenta" };
+static int sim_topo_buildstep= -1; // -1 when no build is in progress
+
+
+void aomw_init() { }
+
+
+// A build costs three telegrams per node (e.g. identify, setup, goactive) and makes all nodes active
+aoresult_t aomw_topo_build() {
+  aomw_topo_build_start();
+  while( !aomw_topo_build_done() ) aomw_topo_build_step();
+  return aoresult_ok;
+}
+void aomw_topo_build_start() { sim_topo_buildstep= 0; }
+aoresult_t aomw_topo_build_step() {
+  sim_tel(1);
+  if( ++sim_topo_buildstep>=3*sim_chain_numnodes() ) for( uint8_t & stat : sim_chain_stat ) stat= AOOSP_STAT_STATE_ACTIVE;
+  return aoresult_ok;
+}
+int  aomw_topo_build_done() { return sim_topo_buildstep>=3*sim_chain_numnodes(); }
+int  aomw_topo_numnodes() { return sim_chain_numnodes(); }
+int  aomw_topo_numtriplets() { return sim_chain_said ? 3*sim_chain_numnodes() : sim_chain_numnodes(); }
+uint32_t aomw_topo_node_id(uint16_t addr) { return sim_chain_said ? 0x00000040 : 0x00000000; }
+aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags) { sim_tel(0); return aoresult_ok; }
+aoresult_t aomw_topo_settriplet(uint16_t tix, const aomw_topo_rgb_t * rgb) { sim_tel(0); sim_settriplets++; return aoresult_ok; }
+void aomw_topo_dim_set(int dim) { sim_chain_dim= dim<0 ? 0 : dim>1024 ? 1024 : dim; }
+int  aomw_topo_dim_get() { return sim_chain_dim; }
+
+
+// === aomw i2c devices ======================================================
+
+
+int      sim_i2c_eeprom= AOMW_EEPROM_DADDR7_STICK;
+int      sim_i2c_iox= 1;
+uint8_t  sim_eeprom[256];
+uint32_t sim_eeprom_bytes;
+int      sim_iox_buts;
+uint32_t sim_iox_scans;
+static int sim_iox_prev, sim_iox_cur; // button state at previous and last scan
+
+
+// Scans the nodes (one telegram each) until the one with the I2C device is found
+aoresult_t aomw_topo_i2cfind(uint8_t daddr7, uint16_t * addr) {
+  uint16_t found= 0;
+  if( sim_i2c_eeprom!=0 && daddr7==sim_i2c_eeprom ) found= 1;
+  if( sim_i2c_iox && daddr7==AOMW_IOX_DADDR7 && sim_chain_numnodes()>=2 ) found= 2;
+  for( uint16_t scan=1; scan<=sim_chain_numnodes(); scan++ ) {
+    sim_tel(1);
+    if( scan==found ) { *addr= found; return aoresult_ok; }
+  }
+  return aoresult_dev_noi2cdev;
+}
+
+
+// Reading the EEPROM costs one telegram per 8 bytes
+aoresult_t aomw_eeprom_read(uint16_t addr, uint8_t daddr7, uint8_t raddr, uint8_t * buf, int count) {
+  for( int pos=0; pos<count; pos+=8 ) sim_tel(1);
+  for( int pos=0; pos<count; pos++ ) buf[pos]= sim_eeprom[(uint8_t)(raddr+pos)];
+  sim_eeprom_bytes+= count;
+  return aoresult_ok;
+}
+
+
+aoresult_t aomw_iox_init(uint16_t addr) { sim_tel(0); sim_iox_prev= sim_iox_cur= 0; return aoresult_ok; }
+aoresult_t aomw_iox_but_scan() { sim_tel(1); sim_iox_scans++; sim_iox_prev= sim_iox_cur; sim_iox_cur= sim_iox_buts; return aoresult_ok; }
+int aomw_iox_but_wentdown(int buts) { return sim_iox_cur & ~sim_iox_prev & buts; }
+int aomw_iox_but_isdown(int buts) { return sim_iox_cur & buts; }
+aoresult_t aomw_iox_led_set(int leds) { sim_tel(0); return aoresult_ok; }
+
+
+// === aomw tscript and flag =================================================
+
+
+static const uint16_t sim_tscript_heartbeat[]= { 0x0001, 0x0002, 0x0003 };
+const uint16_t * aomw_tscript_heartbeat() { return sim_tscript_heartbeat; }
+int  aomw_tscript_heartbeat_bytes() { return sizeof sim_tscript_heartbeat; }
+const uint16_t * sim_tscript_insts;
+void aomw_tscript_install(const uint16_t * insts, int numtriplets) { sim_tscript_insts= insts; }
+aoresult_t aomw_tscript_playframe() { sim_tel(0); sim_frames++; return aoresult_ok; }
+
+
+// A flag paints every triplet
+static aoresult_t sim_flag_paint() {
+  for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
+    aoresult_t result= aomw_topo_settriplet(tix, &aomw_topo_red);
+    if( result!=aoresult_ok ) return result;
+  }
+  return aoresult_ok;
+}
+static const char * sim_flag_names[]= { "dutch", "mali", "europe", "italy" };
+aomw_flag_painter_t aomw_flag_painter(int pix) { return sim_flag_paint; }
+int aomw_flag_count() { return sizeof sim_flag_names / sizeof sim_flag_names[0]; }
+const char * aomw_flag_name(int pix) { return sim_flag_names[pix]; }
+
+
+// === aoui32 ================================================================
+
+
+int sim_ui32_buts;
+static int sim_ui32_prev, sim_ui32_cur; // button state at previous and last scan
+
+
+void aoui32_init() { }
+void aoui32_but_scan() { sim_ui32_prev= sim_ui32_cur; sim_ui32_cur= sim_ui32_buts; }
+int  aoui32_but_wentdown(int buts) { return sim_ui32_cur & ~sim_ui32_prev & buts; }
+int  aoui32_but_isdown(int buts) { return sim_ui32_cur & buts; }
+int  aoui32_but_wentup(int buts) { return ~sim_ui32_cur & sim_ui32_prev & buts; }
+void aoui32_led_on(int leds) { }
+void aoui32_led_off(int leds) { }
+void aoui32_led_toggle(int leds) { }
+void aoui32_oled_msg(const char * msg) { }
+void aoui32_oled_state(const char * top, const char * xlbl, const char * ylbl) { }
+
+
+// === aocmd =================================================================
+
+
+#define SIM_CMD_MAX     8  // number of commands that can be registered
+#define SIM_CMD_MAXARGS 32 // number of arguments of a command line
+
+
+static struct { aocmd_cint_func_t main; const char * name; } sim_cmd_table[SIM_CMD_MAX];
+static int sim_cmd_count;
+
+
+int aocmd_cint_register(aocmd_cint_func_t main, const char * name, const char * shorthelp, const char * longhelp) {
+  if( sim_cmd_count==SIM_CMD_MAX ) return -1;
+  sim_cmd_table[sim_cmd_count].main= main;
+  sim_cmd_table[sim_cmd_count].name= name;
+  sim_cmd_count++;
+  return SIM_CMD_MAX-sim_cmd_count;
+}
+
+
+bool aocmd_cint_isprefix(const char * full, const char * prefix) {
+  return *prefix!=0 && strncmp(full, prefix, strlen(prefix))==0;
+}
+
+
+bool aocmd_cint_parse_dec(const char * str, int * val) {
+  char * end;
+  long num= strtol(str, &end, 10);
+  if( *str==0 || *end!=0 ) return false;
+  *val= (int)num;
+  return true;
+}
+
+
+// Splits `line` (in place) into arguments, and calls the handler of the command (argv[0], optional @-prefix)
+static void sim_cmd_exec(char * line) {
+  char * argv[SIM_CMD_MAXARGS];
+  int argc= 0;
+  for( char * arg= strtok(line," \t\r\n"); arg!=0 && argc<SIM_CMD_MAXARGS; arg= strtok(0," \t\r\n") ) argv[argc++]= arg;
+  if( argc==0 ) return;
+  const char * name= argv[0][0]=='@' ? argv[0]+1 : argv[0];
+  for( int ix=0; ix<sim_cmd_count; ix++ ) 
+    if( strcmp(sim_cmd_table[ix].name, name)==0 ) { sim_cmd_table[ix].main(argc, argv); return; }
+  Serial.printf("ERROR: command '%s' not found\n", name);
+}
+
+
+void sim_cmd(const char * line) {
+  char buf[256];
+  snprintf(buf, sizeof buf, "%s", line);
+  sim_cmd_exec(buf);
+}
+
+
+// Like aocmd: reads all available bytes, and executes a command when a line is complete
+void aocmd_cint_pollserial() {
+  static char line[256];
+  static int  len;
+  while( Serial.available()>0 ) {
+    int ch= Serial.read();
+    if( ch=='\n' || ch=='\r' ) {
+      line[len]= '\0';
+      sim_cmd_exec(line);
+      len= 0;
+    } else if( len<(int)sizeof(line)-1 ) {
+      line[len++]= ch;
+    }
+  }
+}
+
+
+// === running ===============================================================
+
+
+uint32_t sim_run(uint32_t ms) {
+  uint64_t end= sim_us + (uint64_t)ms*1000;
+  uint32_t steps= 0;
+  while( sim_us<end ) {
+    aoapps_mngr_step();
+    steps++;
+    delay( aoapps_mngr_idle_ms() );
+  }
+  return steps;
+}
+
+
+// === test support ==========================================================
+
+
+static int sim_checks, sim_fails;
+
+
+void sim_check(int ok, const char * cond, const char * file, int line) {
+  sim_checks++;
+  if( ok ) return;
+  sim_fails++;
+  printf("FAIL: %s (%s:%d)\n", cond, file, line);
+}
+
+
+int sim_report(const char * name) {
+  printf("%s: %d checks, %d failed\n", name, sim_checks, sim_fails);
+  int code= sim_fails==0 ? 0 : 1;
+  fflush(stdout);
+  // The animation task (a detached thread) never ends; do not run static destructors under its feet
+  if( sim_task_started ) _exit(code);
+  return code;
+}
@@ -0,0 +1,108 @@
+// sim.h - virtual OSP chain and host stand-ins, so that aoapps runs (and can be profiled) on a workstation
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _SIM_H_
+#define _SIM_H_
+
+
+#include <stdint.h>       // uint64_t
+#include <atomic>         // std::atomic
+
+
+/*
+SIM - host build of aoapps
+
+DESCRIPTION
+- Implements the stand-in headers in stubs/ (Arduino, FreeRTOS, aoresult, 
+  aospi, aoosp, aomw, aoui32, aocmd) on top of a virtual OSP chain
+- The chain has N nodes, all RGBIs (one triplet) or all SAIDs (three 
+  triplets); node 001 may have an I2C EEPROM, node 002 an I/O-expander
+- Time is virtual: every telegram advances it by sim_tel_us, delay() by 
+  the requested time, and every micros() call by 1us (so code has cost)
+- Serial output goes to stdout, or is captured; Serial input is fed by 
+  the test (text commands or binary frames)
+
+USAGE
+- sim_chain(N,said) before aoapps_init(), then register and start apps
+- sim_run() steps the manager for a stretch of virtual time, sleeping 
+  aoapps_mngr_idle_ms() between steps (like the loop() of a sketch)
+- Tests use SIM_CHECK(), and return sim_report() from main()
+*/
+
+
+// Virtual time (in us); read by millis()/micros(), atomic because the animation task (a std::thread) reads it too
+extern std::atomic<uint64_t> sim_us;
+// Wire time (in us) of one telegram
+extern uint32_t sim_tel_us;
+
+
+// Configures a chain of `numnodes` nodes (SAIDs with three triplets when `said`, else RGBIs); all nodes uninitialized
+void sim_chain(int numnodes, int said);
+// Puts all nodes in SLEEP (as an under-voltage event does); they keep their address
+void sim_chain_sleepall();
+// Puts node `addr` in SLEEP
+void sim_chain_sleep(uint16_t addr);
+// Returns the number of nodes that are not ACTIVE
+int  sim_chain_numinactive();
+
+
+// Telegram counters (since sim_chain), per kind
+extern uint32_t sim_tx;          // all telegrams sent
+extern uint32_t sim_rx;          // all telegrams with a response
+extern uint32_t sim_settriplets; // aomw_topo_settriplet() calls
+extern uint32_t sim_identifies;  // aoosp_send_identify() telegrams
+extern uint32_t sim_readstats;   // aoosp_send_readstat() telegrams (the repair sampling)
+extern uint32_t sim_unicasts;    // clrerror/goactive to one node
+extern uint32_t sim_broadcasts;  // clrerror/goactive to all nodes
+extern uint32_t sim_frames;      // aomw_tscript_playframe() calls
+extern const uint16_t * sim_tscript_insts; // script last installed with aomw_tscript_install()
+
+
+// I2C devices: the EEPROM (256 bytes, on node 001) and the I/O-expander (on node 002), present when enabled
+extern int      sim_i2c_eeprom;
+extern int      sim_i2c_iox;
+extern uint8_t  sim_eeprom[256];
+extern uint32_t sim_eeprom_bytes; // bytes read from the EEPROM
+extern int      sim_iox_buts;     // buttons (AOMW_IOX_BUTx) currently down
+extern uint32_t sim_iox_scans;    // aomw_iox_but_scan() calls
+extern int      sim_ui32_buts;    // buttons (AOUI32_BUT_x) currently down
+
+
+// Serial: appends bytes to the input (read by aocmd_cint_pollserial() or aoapps_mngr_bin_pollserial())
+void sim_serial_feed(const uint8_t * buf, int size);
+void sim_serial_feedstr(const char * str);
+// Serial output: when capturing, output is appended to the capture buffer instead of printed
+void sim_serial_capture(int enable);
+int  sim_serial_captured(uint8_t * buf, int size); // moves (at most size) captured bytes to buf, returns count
+
+
+// Executes one text command (as aocmd_cint would, e.g. "apps switch 2")
+void sim_cmd(const char * line);
+// Steps the manager for `ms` of virtual time, sleeping aoapps_mngr_idle_ms() between steps; returns number of steps
+uint32_t sim_run(uint32_t ms);
+
+
+// Test support
+#define SIM_CHECK(cond) sim_check( (cond), #cond, __FILE__, __LINE__ )
+void sim_check(int ok, const char * cond, const char * file, int line);
+int  sim_report(const char * name); // prints the summary; returns the exit code for main()
+
+
+#endif
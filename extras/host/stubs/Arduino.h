@@ -0,0 +1,62 @@
+// Arduino.h - host stand-in: virtual time, Serial, and the FreeRTOS task API used by aoapps
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _ARDUINO_H_
+#define _ARDUINO_H_
+
+
+#include <stdint.h>       // uint32_t
+#include <stddef.h>       // size_t
+#include <stdio.h>        // vprintf()
+#include <string.h>       // strlen()
+#include <stdarg.h>       // va_list
+
+
+// Virtual time (see sim.h), advanced by delay() and by telegrams on the virtual chain
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+
+
+// Serial: output goes to stdout (or is captured), input is fed by the test (see sim.h)
+class HostSerial {
+public:
+  int    printf(const char * format, ...) __attribute__((format(printf,2,3)));
+  int    available();
+  int    peek();
+  int    read();
+  size_t write(uint8_t byte);
+  size_t write(const uint8_t * buf, size_t size);
+};
+extern HostSerial Serial;
+
+
+// FreeRTOS (the subset used by aoapps_mngr), implemented with std::thread
+typedef void * TaskHandle_t;
+typedef int    BaseType_t;
+typedef void (*TaskFunction_t)(void *);
+#define pdPASS              1
+#define pdMS_TO_TICKS(ms)   (ms)
+BaseType_t   xTaskCreatePinnedToCore(TaskFunction_t func, const char * name, uint32_t stack, void * param, int prio, TaskHandle_t * handle, int core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void         vTaskDelay(uint32_t ticks);
+
+
+#endif
@@ -0,0 +1,89 @@
+// aomw.h - host stand-in for the OSP Middleware library (topo, eeprom, iox, tscript, flag)
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AOMW_H_
+#define _AOMW_H_
+
+
+#include <stdint.h>       // uint16_t
+#include <aoresult.h>     // aoresult_t
+
+
+void aomw_init();
+
+
+// topo
+typedef struct aomw_topo_rgb_s { uint16_t r; uint16_t g; uint16_t b; const char * name; } aomw_topo_rgb_t;
+extern const aomw_topo_rgb_t aomw_topo_red, aomw_topo_yellow, aomw_topo_green, aomw_topo_cyan, aomw_topo_magenta;
+#define AOMW_TOPO_BRIGHTNESS_MAX 0x7FFF
+aoresult_t aomw_topo_build();
+void       aomw_topo_build_start();
+aoresult_t aomw_topo_build_step();
+int        aomw_topo_build_done();
+int        aomw_topo_numnodes();
+int        aomw_topo_numtriplets();
+uint32_t   aomw_topo_node_id(uint16_t addr);
+aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags);
+aoresult_t aomw_topo_settriplet(uint16_t tix, const aomw_topo_rgb_t * rgb);
+void       aomw_topo_dim_set(int dim);
+int        aomw_topo_dim_get();
+aoresult_t aomw_topo_i2cfind(uint8_t daddr7, uint16_t * addr);
+
+
+// eeprom
+#define AOMW_EEPROM_DADDR7_SAIDBASIC 0x50
+#define AOMW_EEPROM_DADDR7_STICK     0x51
+aoresult_t aomw_eeprom_read(uint16_t addr, uint8_t daddr7, uint8_t raddr, uint8_t * buf, int count);
+
+
+// iox
+#define AOMW_IOX_DADDR7   0x20
+#define AOMW_IOX_BUT0     0x01
+#define AOMW_IOX_BUT1     0x02
+#define AOMW_IOX_BUT2     0x04
+#define AOMW_IOX_BUT3     0x08
+#define AOMW_IOX_LED(i)   (1<<(i))
+#define AOMW_IOX_LEDNONE  0x00
+aoresult_t aomw_iox_init(uint16_t addr);
+aoresult_t aomw_iox_but_scan();
+int        aomw_iox_but_wentdown(int buts);
+int        aomw_iox_but_isdown(int buts);
+aoresult_t aomw_iox_led_set(int leds);
+
+
+// tscript
+const uint16_t * aomw_tscript_heartbeat();
+int              aomw_tscript_heartbeat_bytes();
+void             aomw_tscript_install(const uint16_t * insts, int numtriplets);
+aoresult_t       aomw_tscript_playframe();
+
+
+// flag
+#define AOMW_FLAG_PIX_DUTCH   0
+#define AOMW_FLAG_PIX_MALI    1
+#define AOMW_FLAG_PIX_EUROPE  2
+#define AOMW_FLAG_PIX_ITALY   3
+typedef aoresult_t (*aomw_flag_painter_t)();
+aomw_flag_painter_t aomw_flag_painter(int pix);
+int                 aomw_flag_count();
+const char *        aomw_flag_name(int pix);
+
+
+#endif
@@ -0,0 +1,56 @@
+// aoosp.h - host stand-in for the OSP Telegrams library (the telegrams used by aoapps)
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AOOSP_H_
+#define _AOOSP_H_
+
+
+#include <stdint.h>       // uint16_t
+#include <aoresult.h>     // aoresult_t
+
+
+// The state field in the status byte returned by aoosp_send_readstat()
+#define AOOSP_STAT_STATE_MASK       0xC0
+#define AOOSP_STAT_STATE_UNINIT     0x00
+#define AOOSP_STAT_STATE_SLEEP      0x40
+#define AOOSP_STAT_STATE_ACTIVE     0x80
+#define AOOSP_STAT_STATE_DEEPSLEEP  0xC0
+
+// Current/flags byte of setcurrents
+#define AOOSP_CURCHN_FLAGS_DITHER   0x08
+#define AOOSP_CURCHN_CUR_DEFAULT    0x01
+
+// Node types returned by aoosp_send_identify()
+#define AOOSP_IDENTIFY_IS_RGBI(id)  ( ((id) & 0xFFFFFFF0) == 0x00000000 )
+#define AOOSP_IDENTIFY_IS_SAID(id)  ( ((id) & 0xFFFFFFF0) == 0x00000040 )
+
+
+void       aoosp_init();
+aoresult_t aoosp_send_clrerror(uint16_t addr);
+aoresult_t aoosp_send_goactive(uint16_t addr);
+aoresult_t aoosp_send_readstat(uint16_t addr, uint8_t * stat);
+aoresult_t aoosp_send_identify(uint16_t addr, uint32_t * id);
+aoresult_t aoosp_send_setpwm(uint16_t addr, uint16_t red, uint16_t green, uint16_t blue, uint8_t daytimes);
+aoresult_t aoosp_send_readpwm(uint16_t addr, uint16_t * red, uint16_t * green, uint16_t * blue, uint8_t * daytimes);
+aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16_t green, uint16_t blue);
+aoresult_t aoosp_send_readpwmchn(uint16_t addr, uint8_t chn, uint16_t * red, uint16_t * green, uint16_t * blue);
+
+
+#endif
@@ -0,0 +1,47 @@
+// aoresult.h - host stand-in for the OSP ResultCodes library
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AORESULT_H_
+#define _AORESULT_H_
+
+
+#include <stdint.h>       // uint8_t
+
+
+// The result codes used by aoapps and by the simulated chain
+typedef enum aoresult_e {
+  aoresult_ok,
+  aoresult_other,
+  aoresult_outofmem,
+  aoresult_sys_arg,
+  aoresult_spi_noclock,
+  aoresult_dev_noi2cdev,
+} aoresult_t;
+
+
+const char * aoresult_to_str(aoresult_t result, int upper=0);
+
+
+// Reports the failed condition and aborts (the firmware would halt)
+void aoresult_assert(const char * cond, const char * file, int line);
+#define AORESULT_ASSERT(cond) do { if( !(cond) ) aoresult_assert(#cond, __FILE__, __LINE__); } while(0)
+
+
+#endif
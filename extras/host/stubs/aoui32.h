@@ -0,0 +1,45 @@
+// aoui32.h - host stand-in for the OSP UIDriversOSP32 library (buttons, LEDs, OLED)
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AOUI32_H_
+#define _AOUI32_H_
+
+
+#define AOUI32_BUT_A    0x01
+#define AOUI32_BUT_B    0x02
+#define AOUI32_BUT_X    0x04
+#define AOUI32_BUT_Y    0x08
+#define AOUI32_LED_GRN  0x01
+#define AOUI32_LED_RED  0x02
+
+
+void aoui32_init();
+void aoui32_but_scan();
+int  aoui32_but_wentdown(int buts);
+int  aoui32_but_isdown(int buts);
+int  aoui32_but_wentup(int buts);
+void aoui32_led_on(int leds);
+void aoui32_led_off(int leds);
+void aoui32_led_toggle(int leds);
+void aoui32_oled_msg(const char * msg);
+void aoui32_oled_state(const char * top, const char * xlbl, const char * ylbl);
+
+
+#endif
@@ -0,0 +1,124 @@
+// test_aniscript.cpp - aniscript caches the EEPROM script, verifies it, and reloads it when any chunk changed
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <Arduino.h>      // millis()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_chain()
+
+
+static int ani_appix;
+
+
+static char ani_out[1024]; // messages of the last (re)start
+
+
+// (Re)starts aniscript until it plays from EEPROM; returns the number of EEPROM bytes read
+static uint32_t ani_restart() {
+  uint8_t out[1024];
+  if( aoapps_mngr_app_running() ) aoapps_mngr_stop();
+  aoapps_mngr_topo_invalidate(); // start (load), instead of resume
+  sim_serial_captured(out, sizeof out); // discard
+  uint32_t bytes0= sim_eeprom_bytes;
+  aoapps_mngr_start(ani_appix);
+  sim_run(2000);
+  int size= sim_serial_captured(out, sizeof(out)-1);
+  out[size]= '\0';
+  SIM_CHECK( strstr((const char *)out, "playing from EEPROM")!=0 );
+  strcpy(ani_out, (const char *)out);
+  // The player plays the script as it is in the EEPROM now
+  SIM_CHECK( sim_tscript_insts!=0 && memcmp(sim_tscript_insts, sim_eeprom, sizeof sim_eeprom)==0 );
+  return sim_eeprom_bytes-bytes0;
+}
+
+
+// Switches to runled and back (A button), so aniscript is suspended and resumed; returns the number of EEPROM bytes read
+static uint32_t ani_resume() {
+  uint8_t out[1024];
+  aoapps_mngr_stop();
+  aoapps_mngr_start( aoapps_mngr_app_find("runled") );
+  sim_run(1000);
+  aoapps_mngr_stop();
+  sim_serial_captured(out, sizeof out); // discard
+  uint32_t bytes0= sim_eeprom_bytes;
+  aoapps_mngr_start(ani_appix);
+  sim_run(2000);
+  int size= sim_serial_captured(out, sizeof(out)-1);
+  out[size]= '\0';
+  SIM_CHECK( strstr((const char *)out, "aniscript: resuming")!=0 );
+  return sim_eeprom_bytes-bytes0;
+}
+
+
+int main() {
+  sim_chain(10, 1);
+  for( int i=0; i<(int)sizeof sim_eeprom; i++ ) sim_eeprom[i]= i*7;
+  sim_serial_capture(1);
+  aoapps_init();
+  aoapps_mngr_cmd_register();
+  aoapps_aniscript_register();
+  aoapps_runled_register();
+  ani_appix= aoapps_mngr_app_find("aniscript");
+
+  uint32_t first= ani_restart();
+  printf("aniscript: first start reads %lu bytes\n", (unsigned long)first);
+  SIM_CHECK( first==sizeof sim_eeprom );
+
+  // Unchanged: the cached script plays after the two probes, the rest is read to verify it
+  uint32_t cached= ani_restart();
+  printf("aniscript: restart (unchanged) reads %lu bytes\n", (unsigned long)cached);
+  SIM_CHECK( cached==sizeof sim_eeprom );
+  SIM_CHECK( strstr(ani_out, "(cached)")!=0 && strstr(ani_out, "(changed)")==0 );
+
+  // Middle chunk changed: the probes match, the verification finds it and swaps the script
+  sim_eeprom[sizeof sim_eeprom/2]^= 0xFF;
+  uint32_t middle= ani_restart();
+  printf("aniscript: restart (middle byte changed) reads %lu bytes\n", (unsigned long)middle);
+  SIM_CHECK( middle==sizeof sim_eeprom );
+  SIM_CHECK( strstr(ani_out, "(changed)")!=0 );
+  ani_restart();
+  SIM_CHECK( strstr(ani_out, "(changed)")==0 );
+
+  // Final chunk changed: probes, then the rest is read
+  sim_eeprom[sizeof sim_eeprom-1]^= 0xFF;
+  uint32_t tail= ani_restart();
+  printf("aniscript: restart (final byte changed) reads %lu bytes\n", (unsigned long)tail);
+  SIM_CHECK( tail>sizeof sim_eeprom );
+  SIM_CHECK( ani_restart()==sizeof sim_eeprom );
+
+  // First chunk changed: one probe, then the rest is read
+  sim_eeprom[0]^= 0xFF;
+  uint32_t head= ani_restart();
+  printf("aniscript: restart (first byte changed) reads %lu bytes\n", (unsigned long)head);
+  SIM_CHECK( head==sizeof sim_eeprom );
+
+  // Reload drops the cache
+  sim_cmd("@apps config aniscript reload");
+  SIM_CHECK( ani_restart()==sizeof sim_eeprom );
+
+  // Resume keeps the script it had, even when the EEPROM changed
+  sim_eeprom[0]^= 0xFF;
+  SIM_CHECK( ani_resume()==0 );
+  SIM_CHECK( memcmp(sim_tscript_insts, sim_eeprom, sizeof sim_eeprom)!=0 );
+  // After a reload, the resume loads the EEPROM again
+  sim_cmd("@apps config aniscript reload");
+  SIM_CHECK( ani_resume()==sizeof sim_eeprom );
+  SIM_CHECK( memcmp(sim_tscript_insts, sim_eeprom, sizeof sim_eeprom)==0 );
+  return sim_report("test_aniscript");
+}
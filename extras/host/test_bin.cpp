@@ -0,0 +1,322 @@
+// test_bin.cpp - binary command channel: exclusive mode, status codes, and commands per second versus the text path
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <chrono>         // std::chrono
+#include <thread>         // std::this_thread
+#include <Arduino.h>      // Serial
+#include <aocmd.h>        // aocmd_cint_pollserial()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_chain()
+
+
+// === host side =============================================================
+
+
+static uint8_t bin_seq;
+
+
+// Returns the CRC-8 (polynomial 0x07, init 0x00), as the app manager computes it
+static uint8_t bin_crc(const uint8_t * buf, int size) {
+  uint8_t crc= 0x00;
+  for( int i=0; i<size; i++ ) {
+    crc^= buf[i];
+    for( int bit=0; bit<8; bit++ ) crc= crc & 0x80 ? (crc<<1)^0x07 : crc<<1;
+  }
+  return crc;
+}
+
+
+// Composes a request frame with the `size` bytes of operations at `ops` in `frame`; returns the frame size
+static int bin_frame(uint8_t * frame, const uint8_t * ops, int size) {
+  frame[0]= AOAPPS_MNGR_BIN_SYNC;
+  frame[1]= size;
+  frame[2]= ++bin_seq;
+  memcpy(&frame[3], ops, size);
+  frame[3+size]= bin_crc(&frame[1], 2+size);
+  return 4+size;
+}
+
+
+// What the sketch does in loop()
+static void bin_loop() {
+  aoapps_mngr_bin_pollserial();
+  aocmd_cint_pollserial();
+}
+
+
+// Parses the captured output: skips text until SYNC, checks LEN and CRC; copies the (last) response payload 
+// to `rsp` and returns its size (-1 when there is no valid response). `*text` gets the number of skipped bytes.
+static int bin_response(uint8_t * rsp, int * text) {
+  static uint8_t out[8192];
+  int size= sim_serial_captured(out, sizeof out);
+  int found= -1;
+  *text= 0;
+  int pos= 0;
+  while( pos<size ) {
+    if( out[pos]!=AOAPPS_MNGR_BIN_SYNC || pos+4>size || pos+4+out[pos+1]>size ) { pos++; (*text)++; continue; }
+    int len= out[pos+1];
+    if( out[pos+2]!=bin_seq || bin_crc(&out[pos+1],2+len)!=out[pos+3+len] ) { pos++; (*text)++; continue; }
+    memcpy(rsp, &out[pos+3], len);
+    found= len;
+    pos+= 4+len;
+  }
+  return found;
+}
+
+
+// Sends one request with the `size` bytes of operations at `ops`, runs loop(), and returns the response size (payload in `rsp`)
+static int bin_exchange(const uint8_t * ops, int size, uint8_t * rsp, int * text=0) {
+  uint8_t frame[4+255];
+  int dummy;
+  sim_serial_feed(frame, bin_frame(frame, ops, size));
+  bin_loop();
+  return bin_response(rsp, text ? text : &dummy);
+}
+
+
+// Returns the captured text output (up to 1023 bytes)
+static const char * bin_text() {
+  static uint8_t out[1024];
+  int size= sim_serial_captured(out, sizeof(out)-1);
+  out[size]= '\0';
+  return (const char *)out;
+}
+
+
+// === tests =================================================================
+
+
+static int bin_swflag;
+static int bin_runled;
+
+
+static void test_mode() {
+  uint8_t rsp[255];
+  uint8_t frame[4+255];
+  const uint8_t state[]= { AOAPPS_MNGR_BIN_OP_STATE };
+
+  // Text mode: a frame is not taken by the binary channel
+  sim_serial_feed(frame, bin_frame(frame, state, sizeof state));
+  aoapps_mngr_bin_pollserial();
+  SIM_CHECK( Serial.available()==sizeof state+4 );
+  sim_serial_feedstr("\n"); // the interpreter drops the line
+  aocmd_cint_pollserial();
+  bin_text();
+
+  // Enter binary mode
+  sim_serial_feedstr("apps bin\n");
+  bin_loop();
+  SIM_CHECK( strstr(bin_text(), "binary mode")!=0 );
+  int size= bin_exchange(state, sizeof state, rsp);
+  SIM_CHECK( size==5 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_OK && (rsp[1]|rsp[2]<<8)==bin_runled && rsp[3]==1 );
+
+  // Binary mode: text commands are not executed, their bytes are dropped
+  sim_serial_feedstr("apps switch 0\n");
+  bin_loop();
+  SIM_CHECK( aoapps_mngr_app_appix()==bin_runled );
+  SIM_CHECK( Serial.available()==0 );
+  SIM_CHECK( strlen(bin_text())==0 );
+
+  // A text line other than "apps text" does not leave binary mode; a frame in between resets the line
+  sim_serial_feedstr("apps tex\n");
+  bin_loop();
+  sim_serial_feedstr("apps ");
+  size= bin_exchange(state, sizeof state, rsp);
+  SIM_CHECK( size==5 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_OK );
+  sim_serial_feedstr("text\n");
+  bin_loop();
+  SIM_CHECK( bin_exchange(state, sizeof state, rsp)==5 );
+
+  // Escape when the host is gone: the text line "apps text" switches back, the next line is a text command again
+  sim_serial_feedstr("apps text\napps switch swflag\n");
+  bin_loop();
+  SIM_CHECK( strstr(bin_text(), "text mode")!=0 );
+  SIM_CHECK( aoapps_mngr_app_appix()==bin_swflag );
+  sim_serial_feedstr("@apps switch runled\n@apps bin\n");
+  bin_loop();
+  sim_run(1000);
+  bin_text();
+  SIM_CHECK( aoapps_mngr_app_appix()==bin_runled );
+
+  // Bytes before a frame are dropped (resync on SYNC)
+  sim_serial_feedstr("noise");
+  size= bin_exchange(state, sizeof state, rsp);
+  SIM_CHECK( size==5 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_OK );
+
+  // CRC error: not executed
+  const uint8_t tonull[]= { AOAPPS_MNGR_BIN_OP_SWITCH, 0, 0 };
+  int len= bin_frame(frame, tonull, sizeof tonull);
+  frame[len-1]^= 0x01;
+  sim_serial_feed(frame, len);
+  bin_loop();
+  int text;
+  size= bin_response(rsp, &text);
+  SIM_CHECK( size==1 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_CRC );
+  SIM_CHECK( aoapps_mngr_app_appix()==bin_runled );
+}
+
+
+static void test_status() {
+  uint8_t rsp[255];
+  uint8_t ops[255];
+  int len, size;
+
+  // Config with arguments that fit a queue entry
+  const char * scan= "scan 20 100";
+  len= 0;
+  ops[len++]= AOAPPS_MNGR_BIN_OP_CONFIG; ops[len++]= bin_swflag; ops[len++]= 0; ops[len++]= strlen(scan);
+  memcpy(&ops[len], scan, strlen(scan)); len+= strlen(scan);
+  size= bin_exchange(ops, len, rsp);
+  SIM_CHECK( size==1 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_OK );
+
+  // Config with arguments that do not fit a queue entry (AOAPPS_MNGR_QUEUE_BUFSIZE is 96): a bad argument, not busy
+  char longarg[121];
+  memset(longarg, 'x', sizeof longarg-1);
+  longarg[sizeof longarg-1]= '\0';
+  len= 0;
+  ops[len++]= AOAPPS_MNGR_BIN_OP_CONFIG; ops[len++]= bin_swflag; ops[len++]= 0; ops[len++]= strlen(longarg);
+  memcpy(&ops[len], longarg, strlen(longarg)); len+= strlen(longarg);
+  size= bin_exchange(ops, len, rsp);
+  SIM_CHECK( size==1 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_ARG );
+
+  // A batch whose response does not fit a frame (60 states of 5 bytes) is rejected, also its switch is not executed
+  len= 0;
+  ops[len++]= AOAPPS_MNGR_BIN_OP_SWITCH; ops[len++]= 0; ops[len++]= 0;
+  for( int i=0; i<60; i++ ) ops[len++]= AOAPPS_MNGR_BIN_OP_STATE;
+  size= bin_exchange(ops, len, rsp);
+  SIM_CHECK( size==1 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_SIZE );
+  SIM_CHECK( aoapps_mngr_app_appix()==bin_runled );
+  // 50 states (250 bytes) do fit
+  size= bin_exchange(ops+3, 50, rsp);
+  SIM_CHECK( size==250 );
+
+  // Unknown op ends the batch
+  const uint8_t unknown[]= { AOAPPS_MNGR_BIN_OP_STATE, 0x7F, AOAPPS_MNGR_BIN_OP_STATE };
+  size= bin_exchange(unknown, sizeof unknown, rsp);
+  SIM_CHECK( size==6 && rsp[5]==AOAPPS_MNGR_BIN_STATUS_OP );
+}
+
+
+// Returns the host time (in us) per command, for `count` commands from `next`; adds the bytes on the wire to `*req` and `*rsp`
+static double bench(int count, int (*next)(uint8_t * buf, int i), uint32_t * req, uint32_t * rsp) {
+  uint8_t buf[300];
+  static uint8_t out[8192];
+  auto t0= std::chrono::steady_clock::now();
+  for( int i=0; i<count; i++ ) {
+    int size= next(buf, i);
+    sim_serial_feed(buf, size);
+    *req+= size;
+    bin_loop();
+    *rsp+= sim_serial_captured(out, sizeof out);
+  }
+  auto t1= std::chrono::steady_clock::now();
+  return std::chrono::duration<double,std::micro>(t1-t0).count()/count;
+}
+
+
+// The commands of the benchmark: configure the scan rates of swflag, and get the state of the manager
+static int bench_text(uint8_t * buf, int i) {
+  if( i%2 ) return snprintf((char *)buf, 300, "apps\n");
+  return snprintf((char *)buf, 300, "apps config swflag scan %d 100\n", 20+i%8);
+}
+static int bench_bin(uint8_t * buf, int i) {
+  uint8_t ops[32];
+  int len= 0;
+  if( i%2 ) {
+    ops[len++]= AOAPPS_MNGR_BIN_OP_STATE;
+  } else {
+    char text[32];
+    int size= snprintf(text, sizeof text, "scan %d 100", 20+i%8);
+    ops[len++]= AOAPPS_MNGR_BIN_OP_CONFIG; ops[len++]= bin_swflag; ops[len++]= 0; ops[len++]= size;
+    memcpy(&ops[len], text, size); len+= size;
+  }
+  return bin_frame(buf, ops, len);
+}
+
+
+static void test_bench() {
+  const int count= 20000;
+  const double baud= 115200/10; // bytes per second (8N1)
+  uint32_t treq= 0, trsp= 0, breq= 0, brsp= 0;
+
+  // Text mode (leave binary mode)
+  const uint8_t totext[]= { AOAPPS_MNGR_BIN_OP_TEXT };
+  uint8_t rsp[255];
+  SIM_CHECK( bin_exchange(totext, sizeof totext, rsp)==1 && rsp[0]==AOAPPS_MNGR_BIN_STATUS_OK );
+  double tus= bench(count, bench_text, &treq, &trsp);
+
+  // Binary mode
+  sim_serial_feedstr("@apps bin\n");
+  bin_loop();
+  double bus= bench(count, bench_bin, &breq, &brsp);
+
+  // Full duplex: the direction with the most bytes limits the command rate
+  double tcps= baud / ( (treq>trsp?treq:trsp)/(double)count );
+  double bcps= baud / ( (breq>brsp?breq:brsp)/(double)count );
+  printf("text  : %5.2f us/cmd on host, %5.1f + %5.1f bytes/cmd, %6.0f cmd/s at 115200 baud\n", tus, treq/(double)count, trsp/(double)count, tcps );
+  printf("binary: %5.2f us/cmd on host, %5.1f + %5.1f bytes/cmd, %6.0f cmd/s at 115200 baud\n", bus, breq/(double)count, brsp/(double)count, bcps );
+  SIM_CHECK( bcps > 2*tcps );
+  SIM_CHECK( bus < tus );
+}
+
+
+// With an animation task: a full queue gives BUSY, and no "queue full" text in between the frames
+static void test_busy() {
+  uint8_t rsp[255];
+  uint8_t ops[64];
+  aoapps_mngr_task_start(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  bin_text();
+  int busy= 0;
+  for( int round=0; round<20; round++ ) {
+    for( int i=0; i<32; i++ ) ops[i]= AOAPPS_MNGR_BIN_OP_STATSRESET;
+    int text;
+    int size= bin_exchange(ops, 32, rsp, &text);
+    SIM_CHECK( size==32 );
+    for( int i=0; i<size; i++ ) {
+      SIM_CHECK( rsp[i]==AOAPPS_MNGR_BIN_STATUS_OK || rsp[i]==AOAPPS_MNGR_BIN_STATUS_BUSY );
+      busy+= rsp[i]==AOAPPS_MNGR_BIN_STATUS_BUSY;
+    }
+    SIM_CHECK( text==0 );
+  }
+  printf("busy: %d of %d posted stats resets\n", busy, 20*32);
+  SIM_CHECK( busy>0 );
+}
+
+
+int main() {
+  sim_chain(10, 1);
+  sim_serial_capture(1);
+  aoapps_init();
+  aoapps_mngr_cmd_register();
+  aoapps_runled_register();
+  aoapps_swflag_register();
+  bin_runled= aoapps_mngr_app_find("runled");
+  bin_swflag= aoapps_mngr_app_find("swflag");
+  aoapps_mngr_start(bin_runled);
+  sim_run(1000);
+  bin_text();
+
+  test_mode();
+  test_status();
+  test_bench();
+  test_busy(); // last: starts the animation task
+  return sim_report("test_bin");
+}
@@ -0,0 +1,134 @@
+// test_queue.cpp - stress test of the command queue between loop() and the animation task (a std::thread)
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <thread>         // std::this_thread
+#include <chrono>         // std::chrono
+#include <Arduino.h>      // millis()
+#include <aocmd.h>        // aocmd_cint_parse_dec()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_chain()
+
+
+// === test app ==============================================================
+// The app "queue" checks that its configuration commands arrive intact, in 
+// order, and in the animation task. The fields are only written by the task.
+
+
+#define QUEUE_NUMCONFIGS 20000
+
+
+static std::atomic<int> queue_last;      // sequence number of the last config command applied
+static std::atomic<int> queue_applied;   // number of config commands applied
+static std::atomic<int> queue_disorder;  // number of config commands that came out of order
+static std::atomic<int> queue_torn;      // number of config commands with corrupted arguments
+static std::atomic<int> queue_wrongtask; // number of config commands not executed by the animation task
+
+
+static aoresult_t queue_start() { return aoresult_ok; }
+static aoresult_t queue_step() { aoapps_mngr_wakeup_at(millis()+5); return aoresult_ok; }
+static void       queue_stop() { }
+
+
+// The payload argument for sequence number `seq`
+static void queue_payload(char * buf, int size, int seq) {
+  snprintf(buf, size, "p%d-%d-%d", seq, seq*7, seq*13);
+}
+
+
+// Handles "apps config queue <seq> <payload>"
+static void queue_cmd(int argc, char * argv[]) {
+  int seq;
+  char payload[32];
+  if( xTaskGetCurrentTaskHandle()==0 ) queue_wrongtask++;
+  if( argc!=5 || !aocmd_cint_parse_dec(argv[3],&seq) ) { queue_torn++; return; }
+  queue_payload(payload, sizeof payload, seq);
+  if( strcmp(argv[4],payload)!=0 ) queue_torn++;
+  if( seq<=queue_last ) queue_disorder++;
+  queue_last= seq;
+  queue_applied++;
+}
+
+
+static constexpr aoapps_mngr_app_t queue_app= {
+  "queue", "Queue test", "-", "-", AOAPPS_MNGR_FLAGS_NONE,
+  queue_start, queue_step, queue_stop, 
+  queue_cmd, "SYNTAX: apps config queue <seq> <payload>\n",
+  0, 0, 0 /* no suspend, resume, on_button */
+};
+static_assert( aoapps_mngr_app_ok(queue_app), "queue descriptor" );
+
+
+// === producer ==============================================================
+
+
+// Executes a text command from loop() (this thread); returns 0 when it was dropped because the queue was full
+static int queue_post(const char * line) {
+  static uint8_t out[4096];
+  sim_cmd(line);
+  int size= sim_serial_captured(out, sizeof(out)-1);
+  out[size]= '\0';
+  return strstr((const char *)out, "queue full")==0;
+}
+
+
+int main() {
+  sim_chain(10, 0);
+  aoapps_init();
+  aoapps_mngr_cmd_register();
+  aoapps_runled_register();
+  aoapps_mngr_register_app(&queue_app);
+  int appix= aoapps_mngr_app_find("queue");
+  aoapps_mngr_start(appix);
+  sim_serial_capture(1);
+  aoapps_mngr_task_start(1);
+
+  // Post config commands, interleaved with switches and stats resets, as fast as possible
+  int configs= 0;
+  int drops= 0;
+  int lastswitch= appix;
+  char line[80];
+  char payload[32];
+  for( int seq=1; seq<=QUEUE_NUMCONFIGS; seq++ ) {
+    if( seq%97==0 ) {
+      int to= seq%2 ? appix : aoapps_mngr_app_find("runled");
+      snprintf(line, sizeof line, "@apps switch %d", to);
+      if( queue_post(line) ) lastswitch= to; else drops++;
+    }
+    if( seq%61==0 && !queue_post("@apps stats reset") ) drops++;
+    queue_payload(payload, sizeof payload, seq);
+    snprintf(line, sizeof line, "@apps config queue %d %s", seq, payload);
+    if( queue_post(line) ) configs++; else drops++;
+    if( seq%8==0 ) std::this_thread::yield();
+  }
+
+  // Wait (real time) until the animation task has drained the queue
+  auto start= std::chrono::steady_clock::now();
+  while( queue_applied<configs && std::chrono::steady_clock::now()-start < std::chrono::seconds(10) ) 
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  printf("queue: %d config commands posted, %d applied, %d commands dropped (queue full)\n", configs, (int)queue_applied, drops);
+  SIM_CHECK( queue_applied==configs );
+  SIM_CHECK( queue_disorder==0 );
+  SIM_CHECK( queue_torn==0 );
+  SIM_CHECK( queue_wrongtask==0 );
+  SIM_CHECK( aoapps_mngr_app_appix()==lastswitch );
+  return sim_report("test_queue");
+}
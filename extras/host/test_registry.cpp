@@ -0,0 +1,102 @@
+// test_registry.cpp - the app registry grows on demand, finds names with a binary search, and does not leak on re-init
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <malloc.h>       // mallinfo2()
+#include <chrono>         // std::chrono
+#include <Arduino.h>      // millis()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_report()
+
+
+static aoresult_t reg_start() { return aoresult_ok; }
+static aoresult_t reg_step() { return aoresult_ok; }
+static void       reg_stop() { }
+
+
+// A table, checked at compile time (also under C++11)
+AOAPPS_MNGR_TABLE( reg_table,
+  { "taba", "Table A", "-", "-", AOAPPS_MNGR_FLAGS_NONE, reg_start, reg_step, reg_stop, 0, 0, 0, 0, 0 },
+  { "tabb", "Table B", "-", "-", AOAPPS_MNGR_FLAGS_NONE, reg_start, reg_step, reg_stop, 0, 0, 0, 0, 0 },
+);
+static_assert( !aoapps_mngr_name_ok("a-b") && !aoapps_mngr_name_ok("") && aoapps_mngr_name_ok("a1B"), "name check" );
+
+
+#define REG_MAXNAMES 1000
+static char reg_names[REG_MAXNAMES][16];
+
+
+// Registers `count` apps with aoapps_mngr_register() (so the manager owns copies of the descriptors)
+static void reg_init(int count) {
+  aoapps_mngr_init();
+  for( int i=0; i<count; i++ ) {
+    snprintf(reg_names[i], sizeof reg_names[i], "app%d", i);
+    aoapps_mngr_register(reg_names[i], "Test", "-", "-", AOAPPS_MNGR_FLAGS_NONE, reg_start, reg_step, reg_stop, 0, 0);
+  }
+}
+
+
+// Returns the average time (ns) of an exact name lookup in a registry of `count` apps
+static double reg_findns(int count) {
+  reg_init(count);
+  const int rounds= 200000;
+  int found= 0;
+  auto t0= std::chrono::steady_clock::now();
+  for( int r=0; r<rounds; r++ ) found+= aoapps_mngr_app_find(reg_names[(r*7919)%count])>0;
+  auto t1= std::chrono::steady_clock::now();
+  SIM_CHECK( found==rounds );
+  return std::chrono::duration<double,std::nano>(t1-t0).count()/rounds;
+}
+
+
+int main() {
+  // Lookup: exact, prefix, ambiguous, none
+  reg_init(20);
+  SIM_CHECK( aoapps_mngr_app_count()==21 ); // plus voidapp
+  SIM_CHECK( aoapps_mngr_app_find("app7")==8 );
+  SIM_CHECK( aoapps_mngr_app_find("app19")==20 );
+  SIM_CHECK( aoapps_mngr_app_find("app1")==2 ); // exact match wins over app10..app19
+  SIM_CHECK( aoapps_mngr_app_find("ap")==AOAPPS_MNGR_FIND_AMBIGUOUS );
+  SIM_CHECK( aoapps_mngr_app_find("vo")==0 );
+  SIM_CHECK( aoapps_mngr_app_find("app20")==AOAPPS_MNGR_FIND_NONE );
+
+  // Table registration: the number of apps is inferred
+  aoapps_mngr_init();
+  aoapps_mngr_register_table(reg_table);
+  SIM_CHECK( aoapps_mngr_app_count()==3 );
+  SIM_CHECK( aoapps_mngr_app_find("tabb")==2 );
+  #if __cplusplus >= 201703L
+    aoapps_mngr_init();
+    aoapps_mngr_register_table<reg_table>();
+    SIM_CHECK( aoapps_mngr_app_count()==3 );
+  #endif
+
+  // Re-init frees the descriptors copied by aoapps_mngr_register(): the heap does not grow
+  reg_init(100);
+  size_t used0= mallinfo2().uordblks;
+  for( int i=0; i<50; i++ ) reg_init(100);
+  size_t used1= mallinfo2().uordblks;
+  printf("registry: heap in use %zu bytes before, %zu bytes after 50 re-inits of 100 apps\n", used0, used1);
+  SIM_CHECK( used1==used0 );
+
+  // Lookup cost grows with log(count)
+  const int counts[]= { 10, 100, REG_MAXNAMES };
+  for( int count : counts ) printf("registry: find in %4d apps: %.0f ns\n", count, reg_findns(count));
+  return sim_report("test_registry");
+}
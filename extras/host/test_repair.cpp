@@ -0,0 +1,82 @@
+// test_repair.cpp - the manager repairs an under voltage event in one step, and finds a single fault within a round
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <Arduino.h>      // millis()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_chain()
+
+
+// Steps the manager until all nodes are active (at most `maxms`); returns the virtual time (in ms) it took
+static uint32_t test_repair_until_active(uint32_t maxms) {
+  uint64_t start= sim_us;
+  while( sim_chain_numinactive()>0 && sim_us-start < (uint64_t)maxms*1000 ) { 
+    aoapps_mngr_step(); 
+    delay( aoapps_mngr_idle_ms() ); 
+  }
+  return (sim_us-start)/1000;
+}
+
+
+static void test_repair(int numnodes) {
+  sim_chain(numnodes, 0);
+  aoapps_init();
+  aoapps_runled_register();
+  aoapps_mngr_start( aoapps_mngr_app_find("runled") );
+  sim_run(10000 + numnodes*10); // topo build, then healthy long enough to back off
+  SIM_CHECK( sim_chain_numinactive()==0 );
+
+  // Healthy chain: sampling load is bounded, independent of the chain length (at most what the broadcast repair costs: 2 telegrams per 250 ms)
+  uint32_t tx0= sim_tx, readstats0= sim_readstats;
+  sim_run(10000);
+  uint32_t readsps= (sim_readstats-readstats0)/10;
+  uint32_t txps= (sim_tx-tx0)/10;
+  SIM_CHECK( readsps <= 8 );
+  
+  // Under voltage: all nodes sleep; one broadcast (not one unicast per node) brings them back
+  uint32_t unicasts0= sim_unicasts, broadcasts0= sim_broadcasts;
+  sim_chain_sleepall();
+  uint32_t uvms= test_repair_until_active(60000);
+  SIM_CHECK( sim_chain_numinactive()==0 );
+  SIM_CHECK( sim_unicasts==unicasts0 );
+  SIM_CHECK( sim_broadcasts-broadcasts0 == 2 ); // clrerror and goactive
+  SIM_CHECK( uvms <= 250 );
+
+  // A single node (the last one) sleeps on a healthy chain: found within one round
+  sim_run(10000);
+  sim_chain_sleep(numnodes);
+  uint32_t onems= test_repair_until_active(60000);
+  SIM_CHECK( sim_chain_numinactive()==0 );
+  SIM_CHECK( onems <= 2000+250 );
+
+  printf("repair %4d nodes: healthy %3lu readstat/s (%lu tel/s), all asleep back in %4lu ms, last node back in %4lu ms\n", numnodes,
+    (unsigned long)readsps, (unsigned long)txps, (unsigned long)uvms, (unsigned long)onems );
+  aoapps_mngr_stop();
+}
+
+
+int main() {
+  sim_serial_capture(1); // discard app messages
+  test_repair(10);
+  test_repair(16);
+  test_repair(100);
+  test_repair(300);
+  test_repair(1000);
+  return sim_report("test_repair");
+}
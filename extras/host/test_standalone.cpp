@@ -0,0 +1,44 @@
+// test_standalone.cpp - an app runs without the manager (as in example aoapps_runled.ino)
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ *****************************************************************************/
+#include <Arduino.h>         // millis()
+#include <aomw.h>            // aomw_topo_build()
+#include <aoapps_runled.h>   // aoapps_runled_start()
+#include "sim.h"             // sim_chain()
+
+
+int main() {
+  // As aoapps_runled.ino: no aoapps_init(), so the manager (registry, statistics) is not initialized
+  sim_chain(10, 0);
+  sim_serial_capture(1); // discard app messages
+  SIM_CHECK( aomw_topo_build()==aoresult_ok );
+  SIM_CHECK( aoapps_runled_start()==aoresult_ok );
+  uint32_t settriplets0= sim_settriplets;
+  aoresult_t result= aoresult_ok;
+  uint64_t end= sim_us + 2000*1000;
+  while( sim_us<end && result==aoresult_ok ) {
+    result= aoapps_runled_step();
+    delay(1);
+  }
+  SIM_CHECK( result==aoresult_ok );
+  printf("standalone: runled painted %lu triplets in 2s\n", (unsigned long)(sim_settriplets-settriplets0) );
+  SIM_CHECK( sim_settriplets>settriplets0 );
+  aoapps_runled_stop();
+  return sim_report("test_standalone");
+}
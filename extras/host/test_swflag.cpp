@@ -0,0 +1,72 @@
+// test_swflag.cpp - swflag scans the I/O-expander buttons at the configured rates
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <Arduino.h>      // millis()
+#include <aoapps.h>       // aoapps_init()
+#include "sim.h"          // sim_chain()
+
+
+static int swflag_appix;
+
+
+// (Re)starts swflag; returns the number of button scans in the first `ms` after the start
+static uint32_t swflag_restart(uint32_t ms) {
+  if( aoapps_mngr_app_running() ) aoapps_mngr_stop();
+  aoapps_mngr_topo_invalidate(); // start (IOX init, scan reset), instead of resume
+  aoapps_mngr_start(swflag_appix);
+  while( !aoapps_mngr_app_running() ) sim_run(1);
+  uint32_t scans0= sim_iox_scans;
+  sim_run(ms);
+  return sim_iox_scans-scans0;
+}
+
+
+int main() {
+  sim_chain(10, 1);
+  sim_serial_capture(1); // discard app messages
+  aoapps_init();
+  aoapps_mngr_cmd_register();
+  aoapps_swflag_register();
+  swflag_appix= aoapps_mngr_app_find("swflag");
+
+  // Default rates: the first step after the start scans
+  SIM_CHECK( swflag_restart(50)>=1 );
+
+  // A slow interval longer than the default one: the first step after the start still scans
+  sim_cmd("@apps config swflag scan 20 500");
+  uint32_t scans= swflag_restart(50);
+  printf("swflag: %lu scans in the first 50 ms (slow 500 ms)\n", (unsigned long)scans);
+  SIM_CHECK( scans==1 );
+  // Idle: the configured slow rate
+  scans= swflag_restart(5000);
+  printf("swflag: %lu scans in 5 s idle (slow 500 ms)\n", (unsigned long)scans);
+  SIM_CHECK( 9<=scans && scans<=11 );
+
+  // A press switches to the fast rate
+  sim_iox_buts= AOMW_IOX_BUT1;
+  sim_run(600);
+  sim_iox_buts= 0;
+  uint32_t scans0= sim_iox_scans;
+  sim_run(1000);
+  scans= sim_iox_scans-scans0;
+  printf("swflag: %lu scans in 1 s after a press (fast 20 ms)\n", (unsigned long)scans);
+  SIM_CHECK( scans>=40 );
+  return sim_report("test_swflag");
+}
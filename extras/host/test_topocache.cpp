@@ -0,0 +1,78 @@
+// test_topocache.cpp - switching between topo apps on an unchanged chain skips the topo build, and still wakes up sleeping nodes
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ *****************************************************************************/
+#include <Arduino.h>      // millis()
+#include <aoapps.h>       // aoapps_init()
+#include <string>         // std::string
+#include "sim.h"          // sim_chain()
+
+
+// An app with topo that sends no telegrams itself
+static aoresult_t blank_start() { return aoresult_ok; }
+static aoresult_t blank_step() { return aoresult_ok; }
+static void blank_stop() { }
+
+
+// Switches to app `name` and runs until the manager started it (after topo build or validation); returns the number of telegrams sent till then
+static uint32_t topocache_switch(const char * name) {
+  if( aoapps_mngr_app_running() ) aoapps_mngr_stop();
+  uint8_t buf[256];
+  sim_serial_captured(buf, sizeof buf); // flush
+  uint32_t tx0= sim_tx;
+  aoapps_mngr_start( aoapps_mngr_app_find(name) );
+  std::string out;
+  while( out.find(" on ")==std::string::npos ) { // "<name>: starting on <n> RGBs"
+    aoapps_mngr_step();
+    int len= sim_serial_captured(buf, sizeof buf);
+    out.append((const char *)buf, len);
+  }
+  return sim_tx-tx0;
+}
+
+
+static void test_topocache(int numnodes, int said) {
+  sim_chain(numnodes, said);
+  topocache_switch("runled"); // topo build
+  SIM_CHECK( sim_chain_numinactive()==0 );
+
+  // Cache hit: a handful of telegrams (validation, wake-up, LEDs off by broadcast), independent of the chain length
+  uint32_t hittx= topocache_switch("blank");
+  SIM_CHECK( hittx < 20 );
+
+  // Under voltage while switching: nodes keep their address but sleep; the cache hit wakes them up
+  sim_chain_sleepall();
+  hittx= topocache_switch("runled");
+  SIM_CHECK( hittx < 20 );
+  SIM_CHECK( sim_chain_numinactive()==0 );
+
+  printf("topocache %4d %s: switch on unchanged chain costs %2lu telegrams\n", numnodes, said?"SAIDs":"RGBIs", (unsigned long)hittx );
+  aoapps_mngr_stop();
+}
+
+
+int main() {
+  sim_serial_capture(1); // discard app messages
+  aoapps_init();
+  aoapps_runled_register();
+  aoapps_mngr_register("blank", "Blank", "-", "-", AOAPPS_MNGR_FLAGS_WITHTOPO, blank_start, blank_step, blank_stop, 0, 0);
+  test_topocache(10, 0);
+  test_topocache(1000, 0);
+  test_topocache(300, 1);
+  return sim_report("test_topocache");
+}
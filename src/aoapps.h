@@ -23,11 +23,12 @@
 
 
 // Identifies lib version
-#define AOAPPS_VERSION "0.2.10"
+#define AOAPPS_VERSION "0.3.0"
 
 
 // Include the (headers of the) modules of this app
 #include <aoapps_mngr.h>       // the app manager
+#include <aoapps_frame.h>      // shadow frame buffer (helper for apps)
 #include <aoapps_runled.h>     // the app "runled" 
 #include <aoapps_swflag.h>     // the app "swflag" 
 #include <aoapps_dither.h>     // the app "dither" 
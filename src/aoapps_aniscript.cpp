@@ -19,9 +19,11 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
  *****************************************************************************/
 #include <Arduino.h>       // Serial.printf
+#include <string.h>        // memcpy()
 #include <aoresult.h>      // AORESULT_ASSERT, aoresult_t
 #include <aoosp.h>         // aoosp_send_clrerror()
-#include <aoui32.h>        // aoui32_but_wentdown()
+#include <aocmd.h>         // aocmd_cint_isprefix()
+#include <aoui32.h>        // AOUI32_BUT_X
 #include <aomw.h>          // aomw_topo_build_start()
 #include <aoapps_mngr.h>   // aoapps_mngr_register
 #include <aoapps_aniscript.h> // own
@@ -41,15 +43,35 @@ DESCRIPTION
 - External EEPROMs are flashed with bouncing-block and color-mix
 
 NOTES
+- When the app is resumed, it does not read the EEPROM again, it continues the script where it was
 - Ensure the I2C EEPROM stick faces "chip up" otherwise there is a short circuit (see PCB labels)
 - Safest is to only swap an EEPROM when USB power is removed
 - On your own risk when swapping life
-- The script loading takes place when starting the app, so either (1) power cycle, (2) reset, (3) A button
+- The script loading takes place when starting the app, so either (1) power cycle, (2) reset, or 
+  (3) "apps config aniscript reload" followed by the A button (switching away and back); the A button 
+  alone resumes the app, which keeps the script it had
+- Loading is spread over several steps (EEPROM search, then reads of AOAPPS_ANISCRIPT_LOAD_CHUNK bytes),
+  so the manager, OLED and buttons stay responsive; meanwhile the heartbeat script plays
+  (unless AOAPPS_ANISCRIPT_LOAD_HEARTBEAT is 0) and is swapped for the EEPROM script once loaded
+- The last EEPROM script stays cached in the load buffer; on a next start the first and the final
+  chunk are read from the EEPROM first, when both match the cached script, that plays right away
+- Scripts have no header or checksum (eepromflasher writes plain instructions), so the other chunks
+  are still read (one per step) to verify the cached script; a change there swaps in the EEPROM script
+- "apps config aniscript reload" drops the cache
 - Note, the tool OSP_aotop/tree/main/examples/eepromflasher allows flashing EEPROMs with the various animation scripts
 
 BUTTONS
 - The X and Y buttons control the FPS level (frames-per-second animation speed).
 
+TIMING
+- Frames are scheduled on absolute deadlines (previous deadline plus frame time),
+  so loop latency does not accumulate and the FPS does not drift
+- A late frame is played immediately; the next frames follow without wait until 
+  the player is back on schedule
+- When more than AOAPPS_ANISCRIPT_ANIM_MAXBEHIND frames are due, the excess is 
+  dropped (not played), and the schedule restarts from now
+- The command "apps config aniscript stats" shows late and dropped frames
+
 GOAL
 - Show that the root MCU can access I2C devices (EEPROM) e.g. for calibration values
 */
@@ -64,81 +86,265 @@ GOAL
 static uint16_t aoapps_aniscript_insts[AOAPPS_ANISCRIPT_MAXNUMINST]; 
 
 
-// This function implements the EEPROM searching scheme as explained 
-// to the user: first a stick, most upstream one, then a built-in, also
-// most upstream one.
-// Either returns 
-// - aoresult_xxx          a real (OSP transmission, or I2C transaction) error
-// - aoresult_dev_noi2cdev when no device was found
-// - aoresult_ok           when a device was found (node *addr, device *daddr7)
-static aoresult_t aoapps_aniscript_find(uint16_t * addr, uint8_t * daddr7) {
-  aoresult_t result;
-  *addr= 0xFFFF;
-  *daddr7= 0xFF;
-  
-  // Is there an "I2C EEPROM stick" in the OSP chain?
-  result= aomw_topo_i2cfind( AOMW_EEPROM_DADDR7_STICK, addr );
-  if( result==aoresult_ok ) { *daddr7= AOMW_EEPROM_DADDR7_STICK; return aoresult_ok; } 
-  if( result!=aoresult_dev_noi2cdev ) return result; // real error
-  
-  // Is there a SAIDbasic board (with an EEPROM) in the OSP chain?
-  result= aomw_topo_i2cfind( AOMW_EEPROM_DADDR7_SAIDBASIC, addr );
-  if( result==aoresult_ok ) { *daddr7= AOMW_EEPROM_DADDR7_SAIDBASIC; return aoresult_ok; } 
-  if( result!=aoresult_dev_noi2cdev ) return result; // real error
+// The EEPROM is read in chunks of this many bytes, one chunk per step
+#ifndef AOAPPS_ANISCRIPT_LOAD_CHUNK
+#define AOAPPS_ANISCRIPT_LOAD_CHUNK 32
+#endif
+static_assert( AOAPPS_ANISCRIPT_LOAD_CHUNK%2==0 && AOAPPS_ANISCRIPT_LOAD_CHUNK<=AOAPPS_ANISCRIPT_MAXNUMINST*2, "AOAPPS_ANISCRIPT_LOAD_CHUNK must be even and fit the script buffer" );
+// When 1, the heartbeat script plays while the EEPROM script is loading; when 0 the LEDs stay dark
+#ifndef AOAPPS_ANISCRIPT_LOAD_HEARTBEAT
+#define AOAPPS_ANISCRIPT_LOAD_HEARTBEAT 1
+#endif
+
+
+// The EEPROM is read into a separate buffer, since the heartbeat might be playing from the script buffer
+static uint16_t aoapps_aniscript_loadbuf[AOAPPS_ANISCRIPT_MAXNUMINST]; 
+
+
+// States of the load state machine.
+// The search scheme is as explained to the user: first a stick, most 
+// upstream one, then a built-in, also most upstream one. We will not 
+// look elsewhere (eg OSP32 EEPROM).
+#define AOAPPS_ANISCRIPT_LOAD_FINDSTICK 1 // next step searches for an I2C EEPROM stick
+#define AOAPPS_ANISCRIPT_LOAD_FINDBASIC 2 // next step searches for an EEPROM on a SAIDbasic board
+#define AOAPPS_ANISCRIPT_LOAD_READ      3 // next step reads a chunk from the EEPROM
+#define AOAPPS_ANISCRIPT_LOAD_PROBE     4 // next step reads the final chunk, to confirm the cached script
+#define AOAPPS_ANISCRIPT_LOAD_VERIFY    5 // the cached script is installed, next step reads a chunk to verify it
+#define AOAPPS_ANISCRIPT_LOAD_DONE      6 // a script is installed (from EEPROM or heartbeat)
+
+
+// The state of the load state machine
+static int      aoapps_aniscript_load_state;
+static uint16_t aoapps_aniscript_load_addr;   // address of the SAID with the EEPROM
+static uint8_t  aoapps_aniscript_load_daddr7; // I2C address of the EEPROM
+static int      aoapps_aniscript_load_offset; // number of bytes read so far
+
+
+// The last script loaded from EEPROM is kept (cached) in the load buffer. When the
+// app is started again, the first and the final chunk (the probes) are read from 
+// the EEPROM; when both match the cached one, the cached script is played right
+// away. The other chunks are then read to verify it (a script that only differs 
+// in between is swapped in once read). "apps config aniscript reload" drops the cache.
+static int      aoapps_aniscript_cache_valid;    // the load buffer holds the cached EEPROM script
+static uint16_t aoapps_aniscript_cache_addr;     // address of the SAID with the EEPROM of the cached script
+static uint8_t  aoapps_aniscript_cache_daddr7;   // I2C address of the EEPROM of the cached script
+static uint32_t aoapps_aniscript_cache_hits;     // number of loads served from the cache
+static uint32_t aoapps_aniscript_cache_misses;   // number of loads that read the whole EEPROM
+static uint16_t aoapps_aniscript_cache_probe[AOAPPS_ANISCRIPT_LOAD_CHUNK/2]; // first or final chunk read from EEPROM
+static int      aoapps_aniscript_cache_reload;   // "reload" was given: a resume loads the script again (instead of keeping it)
+static int      aoapps_aniscript_cache_stale;    // verification found a chunk that differs from the cached script
+
+
+// Copies the script in `insts` (`bytes` long) to the script buffer and installs it at the player.
+static void aoapps_aniscript_load_install(const uint16_t * insts, int bytes) {
+  memcpy( aoapps_aniscript_insts, insts, bytes );
+  aomw_tscript_install( aoapps_aniscript_insts, aomw_topo_numtriplets() );
+}
+
 
-  // We will not look elsewhere (eg OSP32 EEPROM); signal we didn't find an EEPROM
-  return aoresult_dev_noi2cdev;
+// Byte offset of the final chunk of a script
+#define AOAPPS_ANISCRIPT_LOAD_FINAL (AOAPPS_ANISCRIPT_MAXNUMINST*2-AOAPPS_ANISCRIPT_LOAD_CHUNK)
+
+
+// Returns if the cached script is from the found EEPROM and has `probe` at byte offset `offset`.
+static int aoapps_aniscript_cache_match(const uint16_t * probe, int offset) {
+  if( !aoapps_aniscript_cache_valid ) return 0;
+  if( aoapps_aniscript_cache_addr!=aoapps_aniscript_load_addr ) return 0;
+  if( aoapps_aniscript_cache_daddr7!=aoapps_aniscript_load_daddr7 ) return 0;
+  return memcmp( (uint8_t*)aoapps_aniscript_loadbuf + offset, probe, AOAPPS_ANISCRIPT_LOAD_CHUNK )==0;
 }
 
 
-// Tries to find an EEPROM, next loads the script (or uses a stock one) 
-// and installs at at the player.
-static aoresult_t aoapps_aniscript_load() {
-  uint16_t addr;
-  uint8_t daddr7;
-  aoresult_t result = aoapps_aniscript_find(&addr,&daddr7);
-  if( result!=aoresult_ok && result!=aoresult_dev_noi2cdev ) return result; 
-  
-  if( result==aoresult_dev_noi2cdev ) {
-    // No EEPROM found, use built-in script
-    Serial.printf("aniscript: no EEPROM, playing 'heartbeat'\n");
-    memcpy( aoapps_aniscript_insts, aomw_tscript_heartbeat(), aomw_tscript_heartbeat_bytes() );
-  } else {
-    // Hack: using array of size n of uint16_t as array of size 2n of uint8_t.
-    // The compiler might pad, so we try to check that here.
-    // Endianess is ignored since we read and write with same processor (see eepromflasher)
-    AORESULT_ASSERT( sizeof(uint8_t[4]) == sizeof(uint16_t[2]) );
-    result= aomw_eeprom_read(addr, daddr7, 0, (uint8_t*)aoapps_aniscript_insts, AOAPPS_ANISCRIPT_MAXNUMINST*2 );
-    if( result!=aoresult_ok ) return result; 
-    Serial.printf("aniscript: playing from EEPROM %02x on SAID %03x \n", daddr7,addr);
-  }
+// Starts loading: the EEPROM search is done in the next steps.
+static void aoapps_aniscript_load_start() {
+  aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_FINDSTICK;
+  aoapps_aniscript_load_addr= 0xFFFF;
+  aoapps_aniscript_load_daddr7= 0xFF;
+  aoapps_aniscript_load_offset= 0;
+  #if AOAPPS_ANISCRIPT_LOAD_HEARTBEAT
+    aoapps_aniscript_load_install( aomw_tscript_heartbeat(), aomw_tscript_heartbeat_bytes() );
+  #endif
+}
 
-  // Install the script
-  aomw_tscript_install( aoapps_aniscript_insts, aomw_topo_numtriplets() );
 
-  return aoresult_ok;
+// Returns if the loading is completed (a script is installed).
+static int aoapps_aniscript_load_done() {
+  return aoapps_aniscript_load_state==AOAPPS_ANISCRIPT_LOAD_DONE;
+}
+
+
+#if ! AOAPPS_ANISCRIPT_LOAD_HEARTBEAT
+// Returns if a script is installed (the cached one is installed while it is verified).
+static int aoapps_aniscript_load_installed() {
+  return aoapps_aniscript_load_state>=AOAPPS_ANISCRIPT_LOAD_VERIFY;
+}
+#endif
+
+
+// One step of the load state machine: searches one kind of EEPROM, or reads 
+// one chunk of the script. Returns an error on a real (OSP transmission, 
+// or I2C transaction) error, not when there is no EEPROM.
+static aoresult_t aoapps_aniscript_load_step() {
+  aoresult_t result;
+  switch( aoapps_aniscript_load_state ) {
+
+    case AOAPPS_ANISCRIPT_LOAD_FINDSTICK:
+      // Is there an "I2C EEPROM stick" in the OSP chain?
+      result= aomw_topo_i2cfind( AOMW_EEPROM_DADDR7_STICK, &aoapps_aniscript_load_addr );
+      if( result!=aoresult_ok && result!=aoresult_dev_noi2cdev ) return result; // real error
+      if( result==aoresult_ok ) {
+        aoapps_aniscript_load_daddr7= AOMW_EEPROM_DADDR7_STICK;
+        aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_READ;
+      } else {
+        aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_FINDBASIC;
+      }
+      return aoresult_ok;
+
+    case AOAPPS_ANISCRIPT_LOAD_FINDBASIC:
+      // Is there a SAIDbasic board (with an EEPROM) in the OSP chain?
+      result= aomw_topo_i2cfind( AOMW_EEPROM_DADDR7_SAIDBASIC, &aoapps_aniscript_load_addr );
+      if( result!=aoresult_ok && result!=aoresult_dev_noi2cdev ) return result; // real error
+      if( result==aoresult_ok ) {
+        aoapps_aniscript_load_daddr7= AOMW_EEPROM_DADDR7_SAIDBASIC;
+        aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_READ;
+      } else {
+        // No EEPROM found, use built-in script
+        Serial.printf("aniscript: no EEPROM, playing 'heartbeat'\n");
+        #if ! AOAPPS_ANISCRIPT_LOAD_HEARTBEAT
+          aoapps_aniscript_load_install( aomw_tscript_heartbeat(), aomw_tscript_heartbeat_bytes() );
+        #endif
+        aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_DONE;
+      }
+      return aoresult_ok;
+
+    case AOAPPS_ANISCRIPT_LOAD_READ: {
+      // Hack: using array of size n of uint16_t as array of size 2n of uint8_t.
+      // The compiler might pad, so we try to check that here.
+      // Endianess is ignored since we read and write with same processor (see eepromflasher)
+      AORESULT_ASSERT( sizeof(uint8_t[4]) == sizeof(uint16_t[2]) );
+      if( aoapps_aniscript_load_offset==0 ) {
+        // Read the first chunk (probe); when the cached script starts the same, probe the final chunk next
+        result= aomw_eeprom_read(aoapps_aniscript_load_addr, aoapps_aniscript_load_daddr7, 0, (uint8_t*)aoapps_aniscript_cache_probe, AOAPPS_ANISCRIPT_LOAD_CHUNK );
+        if( result!=aoresult_ok ) return result; 
+        if( aoapps_aniscript_cache_match(aoapps_aniscript_cache_probe,0) ) {
+          aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_PROBE;
+          return aoresult_ok;
+        }
+        // Not cached: the load buffer gets the new script (so the cache is dropped)
+        aoapps_aniscript_cache_valid= 0;
+        memcpy( aoapps_aniscript_loadbuf, aoapps_aniscript_cache_probe, AOAPPS_ANISCRIPT_LOAD_CHUNK );
+        aoapps_aniscript_load_offset= AOAPPS_ANISCRIPT_LOAD_CHUNK;
+        return aoresult_ok;
+      }
+      int size= AOAPPS_ANISCRIPT_MAXNUMINST*2 - aoapps_aniscript_load_offset;
+      if( size>AOAPPS_ANISCRIPT_LOAD_CHUNK ) size= AOAPPS_ANISCRIPT_LOAD_CHUNK;
+      result= aomw_eeprom_read(aoapps_aniscript_load_addr, aoapps_aniscript_load_daddr7, aoapps_aniscript_load_offset, (uint8_t*)aoapps_aniscript_loadbuf + aoapps_aniscript_load_offset, size );
+      if( result!=aoresult_ok ) return result; 
+      aoapps_aniscript_load_offset+= size;
+      if( aoapps_aniscript_load_offset == AOAPPS_ANISCRIPT_MAXNUMINST*2 ) {
+        // Complete script read: swap it in
+        Serial.printf("aniscript: playing from EEPROM %02x on SAID %03x \n", aoapps_aniscript_load_daddr7,aoapps_aniscript_load_addr);
+        aoapps_aniscript_load_install( aoapps_aniscript_loadbuf, sizeof aoapps_aniscript_loadbuf );
+        aoapps_aniscript_cache_valid= 1;
+        aoapps_aniscript_cache_addr= aoapps_aniscript_load_addr;
+        aoapps_aniscript_cache_daddr7= aoapps_aniscript_load_daddr7;
+        aoapps_aniscript_cache_misses++;
+        aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_DONE;
+      }
+      return aoresult_ok;
+    }
+
+    case AOAPPS_ANISCRIPT_LOAD_PROBE:
+      // Read the final chunk (probe), and use the cached script if it ends the same
+      result= aomw_eeprom_read(aoapps_aniscript_load_addr, aoapps_aniscript_load_daddr7, AOAPPS_ANISCRIPT_LOAD_FINAL, (uint8_t*)aoapps_aniscript_cache_probe, AOAPPS_ANISCRIPT_LOAD_CHUNK );
+      if( result!=aoresult_ok ) return result; 
+      if( aoapps_aniscript_cache_match(aoapps_aniscript_cache_probe,AOAPPS_ANISCRIPT_LOAD_FINAL) ) {
+        Serial.printf("aniscript: playing from EEPROM %02x on SAID %03x (cached)\n", aoapps_aniscript_load_daddr7,aoapps_aniscript_load_addr);
+        aoapps_aniscript_load_install( aoapps_aniscript_loadbuf, sizeof aoapps_aniscript_loadbuf );
+        aoapps_aniscript_cache_stale= 0;
+        aoapps_aniscript_load_offset= AOAPPS_ANISCRIPT_LOAD_CHUNK;
+        aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_VERIFY;
+        return aoresult_ok;
+      }
+      // Not cached: the first chunk in the load buffer is still valid, read the rest
+      aoapps_aniscript_cache_valid= 0;
+      aoapps_aniscript_load_offset= AOAPPS_ANISCRIPT_LOAD_CHUNK;
+      aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_READ;
+      return aoresult_ok;
+
+    case AOAPPS_ANISCRIPT_LOAD_VERIFY:
+      // Read one of the chunks between the probes; a chunk that differs replaces the cached one
+      if( aoapps_aniscript_load_offset < AOAPPS_ANISCRIPT_LOAD_FINAL ) {
+        result= aomw_eeprom_read(aoapps_aniscript_load_addr, aoapps_aniscript_load_daddr7, aoapps_aniscript_load_offset, (uint8_t*)aoapps_aniscript_cache_probe, AOAPPS_ANISCRIPT_LOAD_CHUNK );
+        if( result!=aoresult_ok ) return result; 
+        if( !aoapps_aniscript_cache_match(aoapps_aniscript_cache_probe,aoapps_aniscript_load_offset) ) {
+          memcpy( (uint8_t*)aoapps_aniscript_loadbuf + aoapps_aniscript_load_offset, aoapps_aniscript_cache_probe, AOAPPS_ANISCRIPT_LOAD_CHUNK );
+          aoapps_aniscript_cache_stale= 1;
+        }
+        aoapps_aniscript_load_offset+= AOAPPS_ANISCRIPT_LOAD_CHUNK;
+        return aoresult_ok;
+      }
+      if( aoapps_aniscript_cache_stale ) {
+        // The EEPROM script differs in between the probes: swap it in (the load buffer now holds it)
+        Serial.printf("aniscript: playing from EEPROM %02x on SAID %03x (changed)\n", aoapps_aniscript_load_daddr7,aoapps_aniscript_load_addr);
+        aoapps_aniscript_load_install( aoapps_aniscript_loadbuf, sizeof aoapps_aniscript_loadbuf );
+        aoapps_aniscript_cache_misses++;
+      } else {
+        aoapps_aniscript_cache_hits++;
+      }
+      aoapps_aniscript_load_state= AOAPPS_ANISCRIPT_LOAD_DONE;
+      return aoresult_ok;
+
+    default:
+      return aoresult_ok;
+  }
 }
 
 
 // === Animation state machine ===============================================
 
 
+// When the player is behind more than this number of frames, the excess frames are dropped
+#define AOAPPS_ANISCRIPT_ANIM_MAXBEHIND 3
+
+
 // Time (in ms) between two LED updates
 static int aoapps_aniscript_anim_frame_ms;
 // The state of the aniscript state machine
-static uint32_t aoapps_aniscript_anim_ms;
+static uint32_t aoapps_aniscript_anim_deadline; // time stamp (in ms) when the next frame is due
+// Statistics of the scheduler
+static uint32_t aoapps_aniscript_anim_played;   // number of frames played
+static uint32_t aoapps_aniscript_anim_late;     // number of frames played one or more frame times after their deadline
+static uint32_t aoapps_aniscript_anim_dropped;  // number of frames not played because the player was too far behind
 
 
 // Step of the aniscript state machine
 static aoresult_t aoapps_aniscript_anim() {
   aoresult_t result;
   
+  // Is there a script to play
+  #if ! AOAPPS_ANISCRIPT_LOAD_HEARTBEAT
+    if( !aoapps_aniscript_load_installed() ) return aoresult_ok; 
+  #endif
+
   // Is it time for an animation step
-  if( millis()-aoapps_aniscript_anim_ms < aoapps_aniscript_anim_frame_ms ) return aoresult_ok; 
-  aoapps_aniscript_anim_ms = millis();
+  uint32_t late_ms= millis()-aoapps_aniscript_anim_deadline;
+  if( (int32_t)late_ms < 0 ) return aoresult_ok; 
+
+  // Is the player (too far) behind schedule
+  uint32_t behind= late_ms / aoapps_aniscript_anim_frame_ms; // frames due besides this one
+  if( behind>0 ) aoapps_aniscript_anim_late++;
+  if( behind>AOAPPS_ANISCRIPT_ANIM_MAXBEHIND ) {
+    aoapps_aniscript_anim_dropped+= behind;
+    aoapps_aniscript_anim_deadline= millis();
+  }
+  // Next deadline is relative to this deadline (not to now), so there is no drift
+  aoapps_aniscript_anim_deadline+= aoapps_aniscript_anim_frame_ms;
 
   result= aomw_tscript_playframe(); 
   if( result!=aoresult_ok ) return result;
+  aoapps_aniscript_anim_played++;
+  aoapps_mngr_stats_frame();
   
   return aoresult_ok;
 }
@@ -148,45 +354,77 @@ static aoresult_t aoapps_aniscript_anim() {
 
 
 #define AOAPPS_ANISCRIPT_BUTTONS_PERKIBI 100 // if macro has value x, num steps is approx log(1024)/log(1+x/1024)
-#define AOAPPS_ANISCRIPT_BUTTONS_MS      200 // step interval (in ms) for auto dim
 
 
-// Handling button presses (to dim down/up)
-static uint32_t aoapps_aniscript_buttons_ms;
-static aoresult_t aoapps_aniscript_buttons_check() {
-  if( aoui32_but_wentdown(AOUI32_BUT_X | AOUI32_BUT_Y) ) {
-    aoapps_aniscript_buttons_ms = millis()-AOAPPS_ANISCRIPT_BUTTONS_MS; // spoof time
-  }
-  if( aoui32_but_isdown(AOUI32_BUT_X | AOUI32_BUT_Y) && millis()-aoapps_aniscript_buttons_ms> AOAPPS_ANISCRIPT_BUTTONS_MS) {
-    aoapps_aniscript_buttons_ms = millis();
-    int step= aoapps_aniscript_anim_frame_ms*AOAPPS_ANISCRIPT_BUTTONS_PERKIBI/1024 +1; // +1 ensures step is not 0
-    if( aoui32_but_isdown(AOUI32_BUT_Y) ) {
-      aoapps_aniscript_anim_frame_ms-= step; 
-      if( aoapps_aniscript_anim_frame_ms < 1 ) aoapps_aniscript_anim_frame_ms= 1;
-    } else {
-      aoapps_aniscript_anim_frame_ms+= step;
-      if( aoapps_aniscript_anim_frame_ms > 2000 ) aoapps_aniscript_anim_frame_ms= 2000;
-    }
-    //Serial.printf("aniscript: frame %d ms\n", aoapps_aniscript_anim_frame_ms );
+// Handles X/Y button events from the manager (to change FPS; press and repeats while held)
+static aoresult_t aoapps_aniscript_on_button(int but, int event) {
+  if( event==AOAPPS_MNGR_BUTTON_RELEASE ) return aoresult_ok;
+  int step= aoapps_aniscript_anim_frame_ms*AOAPPS_ANISCRIPT_BUTTONS_PERKIBI/1024 +1; // +1 ensures step is not 0
+  if( but==AOUI32_BUT_Y ) {
+    aoapps_aniscript_anim_frame_ms-= step; 
+    if( aoapps_aniscript_anim_frame_ms < 1 ) aoapps_aniscript_anim_frame_ms= 1;
+  } else {
+    aoapps_aniscript_anim_frame_ms+= step;
+    if( aoapps_aniscript_anim_frame_ms > 2000 ) aoapps_aniscript_anim_frame_ms= 2000;
   }
+  //Serial.printf("aniscript: frame %d ms\n", aoapps_aniscript_anim_frame_ms );
   return aoresult_ok;
 }
 
 
+// === Configuration handler =================================================
+// This application has no configuration, but it can show its timing 
+// statistics, and drop its script cache
+
+
+// The handler for the "apps config aniscript" command
+static void aoapps_aniscript_cmd_main( int argc, char * argv[] ) {
+  AORESULT_ASSERT( argc>3 );
+  if( aocmd_cint_isprefix("stats",argv[3]) ) {
+    if( argc!=4 ) { Serial.printf("ERROR: 'aniscript' has too many args\n" ); return; }
+    Serial.printf("frame %d ms\n", aoapps_aniscript_anim_frame_ms );
+    Serial.printf("played %lu\n", (unsigned long)aoapps_aniscript_anim_played );
+    Serial.printf("late %lu\n", (unsigned long)aoapps_aniscript_anim_late );
+    Serial.printf("dropped %lu\n", (unsigned long)aoapps_aniscript_anim_dropped );
+    Serial.printf("cache hits %lu misses %lu\n", (unsigned long)aoapps_aniscript_cache_hits, (unsigned long)aoapps_aniscript_cache_misses );
+    return;
+  } else if( aocmd_cint_isprefix("reload",argv[3]) ) {
+    if( argc!=4 ) { Serial.printf("ERROR: 'aniscript' has too many args\n" ); return; }
+    aoapps_aniscript_cache_valid= 0;
+    aoapps_aniscript_cache_reload= 1;
+    Serial.printf("aniscript: cache dropped, next start or resume reads the whole EEPROM\n" );
+    return;
+  } else {
+    Serial.printf("ERROR: 'aniscript' has unknown argument (%s)\n",argv[3] ); return;
+  }
+}
+
+
+// The long help text for the "apps config aniscript" command.
+static const char aoapps_aniscript_cmd_help[] = 
+  "SYNTAX: apps config aniscript stats\n"
+  "- shows frame time and number of played, late and dropped frames\n"
+  "- shows number of script loads confirmed from cache (hits) and read from EEPROM (misses)\n"
+  "SYNTAX: apps config aniscript reload\n"
+  "- drops the cached script, so the next start (or resume) reads the whole EEPROM\n"
+;
+
+
 // === Top-level state machine ===============================================
 
 
 // The application manager entry point (start)
 static aoresult_t aoapps_aniscript_start() {
-  aoresult_t result;
-  
-  // Find and load the most appropriate EEPROM in the OSP chain
-  result= aoapps_aniscript_load();
-  if( result!=aoresult_ok ) return result;
+  // Find and load the most appropriate EEPROM in the OSP chain (in the next steps)
+  aoapps_aniscript_cache_reload= 0;
+  aoapps_aniscript_load_start();
   
   // Record time stamp of painting
   aoapps_aniscript_anim_frame_ms= 100;
-  aoapps_aniscript_anim_ms= millis();
+  aoapps_aniscript_anim_deadline= millis();
+  aoapps_aniscript_anim_played= 0;
+  aoapps_aniscript_anim_late= 0;
+  aoapps_aniscript_anim_dropped= 0;
   
   return aoresult_ok;
 }
@@ -195,12 +433,16 @@ static aoresult_t aoapps_aniscript_start() {
 // The application manager entry point (step)
 static aoresult_t aoapps_aniscript_step() {
   aoresult_t result;
-  // check ui32 buttons
-  result= aoapps_aniscript_buttons_check();
-  if( result!=aoresult_ok ) return result;
-  // actual animation
+  // actual animation (buttons are handled by aoapps_aniscript_on_button)
   result= aoapps_aniscript_anim();
   if( result!=aoresult_ok ) return result;
+  // load the script (one chunk per step) after the frame, so the frame is on time
+  if( !aoapps_aniscript_load_done() ) {
+    result= aoapps_aniscript_load_step();
+    if( result!=aoresult_ok ) return result;
+  }
+  // tell the manager when the next frame is due (while loading there is work in every step)
+  if( aoapps_aniscript_load_done() ) aoapps_mngr_wakeup_at(aoapps_aniscript_anim_deadline);
   // return success
   return aoresult_ok;
 }
@@ -212,9 +454,40 @@ static void aoapps_aniscript_stop() {
 }
 
 
+// The application manager entry point (suspend)
+static void aoapps_aniscript_suspend() {
+  // Nothing to restore; the loaded script and its play position are kept (also a partial load)
+}
+
+
+// The application manager entry point (resume)
+static aoresult_t aoapps_aniscript_resume() {
+  // A reload was requested while suspended: find and load the EEPROM again (in the next steps)
+  if( aoapps_aniscript_cache_reload ) {
+    aoapps_aniscript_cache_reload= 0;
+    aoapps_aniscript_load_start();
+  }
+  // Play next frame now; the time suspended does not count as late
+  aoapps_aniscript_anim_deadline= millis();
+  return aoresult_ok;
+}
+
+
 // === Registration ==========================================================
 
 
+// The descriptor of the aniscript app (constexpr: checked at compile time, stored in flash)
+static constexpr aoapps_mngr_app_t aoapps_aniscript_app= { 
+  "aniscript", "Animation script", "FPS -", "FPS +",
+  AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR,
+  aoapps_aniscript_start, aoapps_aniscript_step, aoapps_aniscript_stop,
+  aoapps_aniscript_cmd_main, aoapps_aniscript_cmd_help,
+  aoapps_aniscript_suspend, aoapps_aniscript_resume,
+  aoapps_aniscript_on_button
+};
+static_assert( aoapps_mngr_app_ok(aoapps_aniscript_app), "aniscript descriptor" );
+
+
 /*!
     @brief  Registers the aniscript app with the app manager.
     @note   This app plays a light shows as defined by an animation script.
@@ -222,13 +495,12 @@ static void aoapps_aniscript_stop() {
             (attached to a SAID with an I2C bridge) in the OSP chain 
             (especially an EEPROM on a insertable I2C stick). If not,
             this app plays a stock script (heartbeat) from ROM.
+    @note   The script is loaded in chunks over several steps; meanwhile
+            the heartbeat plays (see AOAPPS_ANISCRIPT_LOAD_HEARTBEAT).
     @note   A typical board to use is the SAIDbasic demo board.
 */
 void aoapps_aniscript_register() {
-  aoapps_mngr_register("aniscript", "Animation script", "FPS -", "FPS +", 
-    AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR, 
-    aoapps_aniscript_start, aoapps_aniscript_step, aoapps_aniscript_stop, 
-    0, 0 /* no config command */ );
+  aoapps_mngr_register_app(&aoapps_aniscript_app);
 }
 
 
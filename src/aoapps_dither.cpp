@@ -21,9 +21,10 @@
 #include <Arduino.h>       // Serial.printf
 #include <aoresult.h>      // AORESULT_ASSERT, aoresult_t
 #include <aoosp.h>         // aoosp_send_clrerror()
-#include <aoui32.h>        // aoui32_but_wentdown()
+#include <aoui32.h>        // AOUI32_BUT_X
 #include <aomw.h>          // aomw_topo_build_start()
 #include <aoapps_mngr.h>   // aoapps_mngr_register
+#include <aoapps_frame.h>  // aoapps_frame_set()
 #include <aoapps_dither.h> // own
 
 
@@ -47,31 +48,51 @@ GOAL
 
 
 // === Animation helpers ====================================================
-// We are lazy: the below functions send multiple telegrams, 
-// that should have been spread over multiple aoapps_dither_anim_step()
+// Setting the dither flag requires one telegram per node. On long chains
+// that takes too long for one step, so it is spread over multiple steps.
 
 
-// For all SAIDs, set the dithering flag of its three channels
-static aoresult_t aoapps_dither_anim_setdither(int enadither) {
-  uint8_t flags = enadither ? AOOSP_CURCHN_FLAGS_DITHER|AOOSP_CURCHN_CUR_DEFAULT : AOOSP_CURCHN_CUR_DEFAULT;
-  // Loop over all nodes to set dithering
-  for( uint16_t addr=1; addr<=aomw_topo_numnodes(); addr++ ) {
-    aoresult_t result= aomw_topo_node_setcurrents(addr, flags);
+// Time budget (in us) per step for setting dither flags (at least one node is done per step).
+// The app also stops when the step budget of the app manager is exhausted.
+#define AOAPPS_DITHER_SETDITHER_US 2000
+
+
+// The state of the (incremental) dither setting
+static int      aoapps_dither_setdither_enable; // the dither flag to be set in all nodes
+static uint16_t aoapps_dither_setdither_addr;   // next node to set; 0 when all nodes are done
+
+
+// Starts setting the dithering flag of all nodes (actual work is done by aoapps_dither_anim_setdither_step)
+static void aoapps_dither_anim_setdither_start(int enadither) {
+  aoapps_dither_setdither_enable= enadither;
+  aoapps_dither_setdither_addr= 1;
+}
+
+
+// For the next nodes, set the dithering flag of its three channels, until the time budget is exhausted
+static aoresult_t aoapps_dither_anim_setdither_step() {
+  if( aoapps_dither_setdither_addr==0 ) return aoresult_ok; // all done
+  uint8_t flags = aoapps_dither_setdither_enable ? AOOSP_CURCHN_FLAGS_DITHER|AOOSP_CURCHN_CUR_DEFAULT : AOOSP_CURCHN_CUR_DEFAULT;
+  uint32_t us0= micros();
+  do {
+    aoresult_t result= aomw_topo_node_setcurrents(aoapps_dither_setdither_addr, flags);
     if( result!=aoresult_ok ) return result;
-  }
+    aoapps_dither_setdither_addr++;
+    if( aoapps_dither_setdither_addr>aomw_topo_numnodes() ) { aoapps_dither_setdither_addr= 0; break; }
+  } while( micros()-us0 < AOAPPS_DITHER_SETDITHER_US && aoapps_mngr_budget_left()>0 );
   return aoresult_ok;
 }
 
 
-// For all triplets, r, g, and b will be set to `dimlvl`
+// For all triplets, r, g, and b will be set to `dimlvl` (only changed triplets are sent)
 static aoresult_t aoapps_dither_anim_setdim(uint16_t dimlvl) {
   aomw_topo_rgb_t rgb= { dimlvl, dimlvl, dimlvl, "grey" };
   // Loop over all triplets to set dimlvl
   for( uint16_t tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
-    aoresult_t result= aomw_topo_settriplet(tix, &rgb);
+    aoresult_t result= aoapps_frame_set(tix, &rgb);
     if( result!=aoresult_ok ) return result;
   }
-  return aoresult_ok;
+  return aoapps_frame_commit();
 }
 
 
@@ -95,22 +116,9 @@ static uint32_t aoapps_dither_anim_ms;
 // Step of the dither state machine
 static aoresult_t aoapps_dither_anim() {
   aoresult_t result;
-  // Was there a request to toggle `enadither`
-  if( aoui32_but_wentdown(AOUI32_BUT_Y) ) {
-    aoapps_dither_anim_enadither= !aoapps_dither_anim_enadither;
-    // Effectuate new dither state
-    result= aoapps_dither_anim_setdither(aoapps_dither_anim_enadither);
-    if( result!=aoresult_ok ) return result;
-    // Several telegrams were sent, delay dim by one step
-    return aoresult_ok;
-  }
-
-  // Was there a request to toggle `enadim`
-  if( aoui32_but_wentdown(AOUI32_BUT_X) ) {
-    aoapps_dither_anim_enadim= !aoapps_dither_anim_enadim;
-    // Trigger an update
-    aoapps_dither_anim_ms= millis()-AOAPPS_DITHER_ANIM_MS;
-  }
+  // Set the dither flag for the next chunk of nodes
+  result= aoapps_dither_anim_setdither_step();
+  if( result!=aoresult_ok ) return result;
 
   // Is it time for a dim animation step
   if( millis()-aoapps_dither_anim_ms < AOAPPS_DITHER_ANIM_MS ) return aoresult_ok; 
@@ -135,11 +143,33 @@ static aoresult_t aoapps_dither_anim() {
   // Effectuate the new level
   result= aoapps_dither_anim_setdim(aoapps_dither_anim_dimlvl);
   if( result!=aoresult_ok ) return result;
+  aoapps_mngr_stats_frame();
   
   return aoresult_ok;
 }
 
 
+// === Button ================================================================
+
+
+// Handles X/Y button events from the manager (press toggles)
+static aoresult_t aoapps_dither_on_button(int but, int event) {
+  if( event!=AOAPPS_MNGR_BUTTON_PRESS ) return aoresult_ok;
+  if( but==AOUI32_BUT_Y ) {
+    // Toggle `enadither`
+    aoapps_dither_anim_enadither= !aoapps_dither_anim_enadither;
+    // Effectuate new dither state (restarts when the previous one is still in progress)
+    aoapps_dither_anim_setdither_start(aoapps_dither_anim_enadither);
+  } else {
+    // Toggle `enadim`
+    aoapps_dither_anim_enadim= !aoapps_dither_anim_enadim;
+    // Trigger an update
+    aoapps_dither_anim_ms= millis()-AOAPPS_DITHER_ANIM_MS;
+  }
+  return aoresult_ok;
+}
+
+
 // === Top-level state machine ==============================================
 
 
@@ -150,12 +180,13 @@ static aoresult_t aoapps_dither_start() {
   aoapps_dither_anim_enadim= 1;
   aoapps_dither_anim_enadither= 1;
   aoapps_dither_anim_ms= millis()-AOAPPS_DITHER_ANIM_MS;
+  // Other apps painted the chain
+  aoapps_frame_reset();
   // Effectuate state
   aoresult_t result;
   result= aoapps_dither_anim_setdim(aoapps_dither_anim_dimlvl);
   if( result!=aoresult_ok ) return result;
-  result= aoapps_dither_anim_setdither(aoapps_dither_anim_enadither);
-  if( result!=aoresult_ok ) return result;
+  aoapps_dither_anim_setdither_start(aoapps_dither_anim_enadither); // completed by the steps
   return aoresult_ok;
 }
 
@@ -166,6 +197,8 @@ static aoresult_t aoapps_dither_step() {
   // actual animation
   result= aoapps_dither_anim();
   if( result!=aoresult_ok ) return result;
+  // tell the manager when the next dim step is due (unless dither flags are still being set)
+  if( aoapps_dither_setdither_addr==0 ) aoapps_mngr_wakeup_at(aoapps_dither_anim_ms+AOAPPS_DITHER_ANIM_MS);
   // return success
   return aoresult_ok;
 }
@@ -173,13 +206,26 @@ static aoresult_t aoapps_dither_step() {
 
 // The application manager entry point (stop)
 static void aoapps_dither_stop() {
-  // nothing to restore
+  // The nodes keep the dither setting; have the next app start with a fresh topo build
+  aoapps_mngr_topo_invalidate();
 }
 
 
 // === Registration ==========================================================
 
 
+// The descriptor of the dither app (constexpr: checked at compile time, stored in flash)
+static constexpr aoapps_mngr_app_t aoapps_dither_app= { 
+  "dither", "Dithering", "dim 0/1", "dither 0/1",
+  AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR,
+  aoapps_dither_start, aoapps_dither_step, aoapps_dither_stop,
+  0, 0 /* no config command */,
+  0, 0 /* no suspend/resume */,
+  aoapps_dither_on_button
+};
+static_assert( aoapps_mngr_app_ok(aoapps_dither_app), "dither descriptor" );
+
+
 /*!
     @brief  Registers the dither app with the app manager.
     @note   This app has a dark to light to dark dimming cycle (in white).
@@ -189,10 +235,7 @@ static void aoapps_dither_stop() {
             feature). The OSP32 board would be enough.
 */
 void aoapps_dither_register() {
-  aoapps_mngr_register("dither", "Dithering", "dim 0/1", "dither 0/1", 
-    AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR, 
-    aoapps_dither_start, aoapps_dither_step, aoapps_dither_stop, 
-    0, 0 /* no config command */ );
+  aoapps_mngr_register_app(&aoapps_dither_app);
 }
 
 
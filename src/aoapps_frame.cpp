@@ -0,0 +1,258 @@
+// aoapps_frame.cpp - shadow frame buffer, so that apps only send telegrams for triplets that changed
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <Arduino.h>       // Serial.printf
+#include <string.h>        // memset()
+#include <aoresult.h>      // aoresult_t
+#include <aoosp.h>         // aoosp_send_setpwm()
+#include <aomw.h>          // aomw_topo_settriplet()
+#include <aoapps_frame.h>  // own
+
+
+/*
+FRAME - This is a helper for apps, not an app
+
+DESCRIPTION
+- Keeps a RAM copy ("shadow") of the RGB value of every triplet in the chain
+- An app "sets" triplets in the shadow, then "commits" the frame
+- The commit only sends telegrams for triplets whose value changed since 
+  the previous commit
+- When the topo dim level changed, all (known) triplets are resent, except
+  black ones (black is black at any dim level); a uniform frame is broadcast
+- Triplets beyond AOAPPS_FRAME_MAXTRIPLETS have no shadow; they are sent 
+  immediately on set
+- The shadow does not know what other apps painted, so an app that uses
+  this module shall call aoapps_frame_reset() in its start()
+- When all triplets get the same color (a "uniform" frame), and the chain 
+  consists of one node type, the commit paints one node with topo, reads 
+  back the PWM settings of that node, and broadcasts those; the cost of such
+  a frame no longer depends on the chain length
+
+GOAL
+- Static or slowly changing content should not cost bus bandwidth
+*/
+
+
+// Bit-sets (one bit per triplet)
+#define AOAPPS_FRAME_WORDS ( (AOAPPS_FRAME_MAXTRIPLETS+31)/32 )
+#define AOAPPS_FRAME_BIT_GET(set,tix) ( (set)[(tix)/32] &  (1UL<<((tix)%32)) )
+#define AOAPPS_FRAME_BIT_SET(set,tix) ( (set)[(tix)/32] |= (1UL<<((tix)%32)) )
+#define AOAPPS_FRAME_BIT_CLR(set,tix) ( (set)[(tix)/32] &= ~(1UL<<((tix)%32)) )
+
+
+// The shadow: last color set per triplet, plus two bit-sets
+static uint16_t aoapps_frame_r[AOAPPS_FRAME_MAXTRIPLETS];
+static uint16_t aoapps_frame_g[AOAPPS_FRAME_MAXTRIPLETS];
+static uint16_t aoapps_frame_b[AOAPPS_FRAME_MAXTRIPLETS];
+static uint32_t aoapps_frame_known[AOAPPS_FRAME_WORDS]; // triplet has been set since reset
+static uint32_t aoapps_frame_dirty[AOAPPS_FRAME_WORDS]; // triplet has been set (to a new value) since the last commit
+static int      aoapps_frame_dim;                       // the topo dim level of the last commit
+static int      aoapps_frame_numsent;                   // number of telegrams sent by the last commit
+
+
+// === Broadcast =============================================================
+// Broadcasting one PWM setting only gives the same result as painting with 
+// topo when all nodes are of the same type (topo scales per node type). For 
+// SAIDs we also require that all three channels drive a triplet (no I2C 
+// bridge), because a broadcast sets all channels.
+
+
+// Minimal number of changed triplets before a uniform frame is broadcast
+#define AOAPPS_FRAME_BROADCAST_MIN 8
+
+
+// Result of classifying the chain
+#define AOAPPS_FRAME_CHAIN_UNKNOWN 0 // not yet classified (since reset)
+#define AOAPPS_FRAME_CHAIN_MIXED   1 // broadcast not possible
+#define AOAPPS_FRAME_CHAIN_RGBI    2 // all nodes are RGBIs
+#define AOAPPS_FRAME_CHAIN_SAID    3 // all nodes are SAIDs with three triplets
+static int aoapps_frame_chain;
+
+
+// Classifies the chain from the node ids in the topo map (once per reset; sends no telegrams)
+static void aoapps_frame_classify() {
+  int numrgbi=0;
+  int numsaid=0;
+  for( uint16_t addr=1; addr<=aomw_topo_numnodes(); addr++ ) {
+    uint32_t id= aomw_topo_node_id(addr);
+    if( AOOSP_IDENTIFY_IS_RGBI(id) ) numrgbi++;
+    else if( AOOSP_IDENTIFY_IS_SAID(id) ) numsaid++;
+  }
+  if( numrgbi==aomw_topo_numnodes() && numrgbi==aomw_topo_numtriplets() ) aoapps_frame_chain= AOAPPS_FRAME_CHAIN_RGBI;
+  else if( numsaid==aomw_topo_numnodes() && 3*numsaid==aomw_topo_numtriplets() ) aoapps_frame_chain= AOAPPS_FRAME_CHAIN_SAID;
+  else aoapps_frame_chain= AOAPPS_FRAME_CHAIN_MIXED;
+}
+
+
+// Paints all triplets in color `rgb`, using broadcast telegrams (chain must be classified as RGBI or SAID)
+static aoresult_t aoapps_frame_broadcast(const aomw_topo_rgb_t * rgb) {
+  aoresult_t result;
+  uint16_t r, g, b;
+  if( aoapps_frame_chain==AOAPPS_FRAME_CHAIN_RGBI ) {
+    // Let topo paint node 001 (triplet 0), and copy its PWM settings to all nodes
+    uint8_t daytimes;
+    result= aomw_topo_settriplet(0, rgb);
+    if( result!=aoresult_ok ) return result;
+    result= aoosp_send_readpwm(0x001, &r, &g, &b, &daytimes);
+    if( result!=aoresult_ok ) return result;
+    result= aoosp_send_setpwm(0x000, r, g, b, daytimes);
+    if( result!=aoresult_ok ) return result;
+    aoapps_frame_numsent+= 3;
+  } else {
+    // Let topo paint node 001 (triplets 0, 1, and 2), and copy its channel PWM settings to all nodes
+    for( uint8_t chn=0; chn<3; chn++ ) {
+      result= aomw_topo_settriplet(chn, rgb);
+      if( result!=aoresult_ok ) return result;
+      result= aoosp_send_readpwmchn(0x001, chn, &r, &g, &b);
+      if( result!=aoresult_ok ) return result;
+      result= aoosp_send_setpwmchn(0x000, chn, r, g, b);
+      if( result!=aoresult_ok ) return result;
+      aoapps_frame_numsent+= 3;
+    }
+  }
+  return aoresult_ok;
+}
+
+
+// Returns 1 iff all triplets are known, at least AOAPPS_FRAME_BROADCAST_MIN are dirty, and all have the same color
+static int aoapps_frame_isuniform() {
+  int numtriplets= aomw_topo_numtriplets();
+  if( numtriplets<AOAPPS_FRAME_BROADCAST_MIN || numtriplets>AOAPPS_FRAME_MAXTRIPLETS ) return 0;
+  int numdirty= 0;
+  for( int tix=0; tix<numtriplets; tix++ ) {
+    if( !AOAPPS_FRAME_BIT_GET(aoapps_frame_known,tix) ) return 0;
+    if( aoapps_frame_r[tix]!=aoapps_frame_r[0] || aoapps_frame_g[tix]!=aoapps_frame_g[0] || aoapps_frame_b[tix]!=aoapps_frame_b[0] ) return 0;
+    if( AOAPPS_FRAME_BIT_GET(aoapps_frame_dirty,tix) ) numdirty++;
+  }
+  return numdirty>=AOAPPS_FRAME_BROADCAST_MIN;
+}
+
+
+// === Shadow ================================================================
+
+
+/*!
+    @brief  Forgets the content of the shadow frame buffer.
+    @note   After a reset, every triplet that is set, will be sent on the 
+            next commit (even when it is set to black).
+    @note   Apps using this module shall call this function from their 
+            start(), since other apps might have painted the chain.
+*/
+void aoapps_frame_reset() {
+  memset( aoapps_frame_known, 0, sizeof aoapps_frame_known );
+  memset( aoapps_frame_dirty, 0, sizeof aoapps_frame_dirty );
+  aoapps_frame_dim= aomw_topo_dim_get();
+  aoapps_frame_numsent= 0;
+  aoapps_frame_chain= AOAPPS_FRAME_CHAIN_UNKNOWN;
+}
+
+
+/*!
+    @brief  Records that triplet `tix` should show color `rgb`.
+    @param  tix
+            The index of the triplet, 0 <= tix < aomw_topo_numtriplets().
+    @param  rgb
+            The color for the triplet (only r, g, and b are used).
+    @return aoresult_ok iff successful
+    @note   The triplet is not sent, that is postponed till 
+            aoapps_frame_commit(), and only when the color differs from 
+            what was sent before.
+    @note   Exception: triplets beyond AOAPPS_FRAME_MAXTRIPLETS have no
+            shadow, they are sent immediately.
+*/
+aoresult_t aoapps_frame_set(uint16_t tix, const aomw_topo_rgb_t * rgb) {
+  if( tix>=AOAPPS_FRAME_MAXTRIPLETS ) return aomw_topo_settriplet(tix, rgb);
+  if( AOAPPS_FRAME_BIT_GET(aoapps_frame_known,tix) && aoapps_frame_r[tix]==rgb->r && aoapps_frame_g[tix]==rgb->g && aoapps_frame_b[tix]==rgb->b ) 
+    return aoresult_ok; // no change
+  aoapps_frame_r[tix]= rgb->r;
+  aoapps_frame_g[tix]= rgb->g;
+  aoapps_frame_b[tix]= rgb->b;
+  AOAPPS_FRAME_BIT_SET(aoapps_frame_known,tix);
+  AOAPPS_FRAME_BIT_SET(aoapps_frame_dirty,tix);
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Sends a telegram for every triplet that was set to a new color 
+            since the previous commit.
+    @return aoresult_ok iff successful
+    @note   If the topo dim level changed since the previous commit, all
+            triplets that were ever set (since reset) are resent, except
+            the black ones.
+    @note   When sending fails, the triplets not yet sent stay dirty, so 
+            they will be sent on the next commit.
+    @note   When all triplets have the same color (and many changed), and
+            the chain consists of nodes of one type, the frame is sent 
+            with a handful of broadcast telegrams. The first such commit
+            after a reset classifies the chain, from the node ids in the 
+            topo map (no telegrams).
+*/
+aoresult_t aoapps_frame_commit() {
+  aoresult_t result;
+  aoapps_frame_numsent= 0;
+  // A new dim level makes all known triplets dirty, except black ones (they do not change)
+  if( aoapps_frame_dim!=aomw_topo_dim_get() ) {
+    aoapps_frame_dim= aomw_topo_dim_get();
+    int numtriplets= aomw_topo_numtriplets();
+    if( numtriplets>AOAPPS_FRAME_MAXTRIPLETS ) numtriplets= AOAPPS_FRAME_MAXTRIPLETS;
+    for( int tix=0; tix<numtriplets; tix++ ) {
+      if( aoapps_frame_known[tix/32]==0 ) { tix|= 31; continue; }
+      if( !AOAPPS_FRAME_BIT_GET(aoapps_frame_known,tix) ) continue;
+      if( aoapps_frame_r[tix]==0 && aoapps_frame_g[tix]==0 && aoapps_frame_b[tix]==0 ) continue;
+      AOAPPS_FRAME_BIT_SET(aoapps_frame_dirty,tix);
+    }
+  }
+  // Fast path for a uniform frame
+  if( aoapps_frame_chain!=AOAPPS_FRAME_CHAIN_MIXED && aoapps_frame_isuniform() ) {
+    if( aoapps_frame_chain==AOAPPS_FRAME_CHAIN_UNKNOWN ) aoapps_frame_classify();
+    if( aoapps_frame_chain!=AOAPPS_FRAME_CHAIN_MIXED ) {
+      aomw_topo_rgb_t rgb= { aoapps_frame_r[0], aoapps_frame_g[0], aoapps_frame_b[0], "frame" };
+      result= aoapps_frame_broadcast(&rgb);
+      if( result!=aoresult_ok ) return result;
+      memset( aoapps_frame_dirty, 0, sizeof aoapps_frame_dirty );
+      return aoresult_ok;
+    }
+  }
+  // Send all dirty triplets (skipping clean words quickly)
+  int numtriplets= aomw_topo_numtriplets();
+  if( numtriplets>AOAPPS_FRAME_MAXTRIPLETS ) numtriplets= AOAPPS_FRAME_MAXTRIPLETS;
+  for( int tix=0; tix<numtriplets; tix++ ) {
+    if( aoapps_frame_dirty[tix/32]==0 ) { tix|= 31; continue; }
+    if( !AOAPPS_FRAME_BIT_GET(aoapps_frame_dirty,tix) ) continue;
+    aomw_topo_rgb_t rgb= { aoapps_frame_r[tix], aoapps_frame_g[tix], aoapps_frame_b[tix], "frame" };
+    result= aomw_topo_settriplet(tix, &rgb);
+    if( result!=aoresult_ok ) return result;
+    AOAPPS_FRAME_BIT_CLR(aoapps_frame_dirty,tix);
+    aoapps_frame_numsent++;
+  }
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Returns the number of telegrams that were sent by the last commit.
+    @return Number of telegrams sent (one per triplet, unless broadcast).
+    @note   Useful to see how much the shadow saves in bus traffic.
+*/
+int aoapps_frame_sent() {
+  return aoapps_frame_numsent;
+}
+
@@ -0,0 +1,43 @@
+// aoapps_frame.h - shadow frame buffer, so that apps only send telegrams for triplets that changed
+/*****************************************************************************
+ * Copyright 2024 by ams OSRAM AG                                            *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AOAPPS_FRAME_H_
+#define _AOAPPS_FRAME_H_
+
+
+#include <aoresult.h>     // aoresult_t
+#include <aomw.h>         // aomw_topo_rgb_t
+
+
+// Number of triplets that have a shadow; triplets beyond this are sent directly
+#define AOAPPS_FRAME_MAXTRIPLETS 1024
+
+
+// Forgets the content of the shadow (typically called from an app's start)
+void aoapps_frame_reset();
+// Records that triplet `tix` should get color `rgb` (only sends when tix has no shadow)
+aoresult_t aoapps_frame_set(uint16_t tix, const aomw_topo_rgb_t * rgb);
+// Sends telegrams for all triplets that changed since the previous commit
+aoresult_t aoapps_frame_commit();
+// Returns the number of telegrams that were sent by the last commit
+int aoapps_frame_sent();
+
+
+#endif
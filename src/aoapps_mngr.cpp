@@ -19,7 +19,10 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
  *****************************************************************************/
 #include <Arduino.h>      // Serial.printf
+#include <stdlib.h>       // realloc()
+#include <string.h>       // memset(), strcmp()
 #include <aocmd.h>        // aocmd_cint_register()
+#include <aospi.h>        // aospi_txcount_get()
 #include <aoosp.h>        // aoosp_send_clrerror()
 #include <aomw.h>         // aomw_topo_build_start()
 #include <aoui32.h>       // aoui32_oled_splash()
@@ -46,34 +49,73 @@ static void aoapps_mngr_voidapp_stop () {
 }
 
 
+static constexpr aoapps_mngr_app_t aoapps_mngr_voidapp= { 
+  "voidapp", "USB command", "--", "--", 
+  0, /* no dither, no repair */
+  aoapps_mngr_voidapp_start, aoapps_mngr_voidapp_step, aoapps_mngr_voidapp_stop, 
+  0, 0, /* no config command */ 
+  0, 0, /* no suspend/resume */
+  0     /* no button handler */
+};
+static_assert( aoapps_mngr_app_ok(aoapps_mngr_voidapp), "voidapp descriptor" );
+
+
 void aoapps_mngr_voidapp_register() {
-  aoapps_mngr_register("voidapp", "USB command", "--", "--", 
-    0, /* no dither, no repair */
-    aoapps_mngr_voidapp_start, aoapps_mngr_voidapp_step, aoapps_mngr_voidapp_stop, 
-    0, 0 /* no config command */ );
+  aoapps_mngr_register_app(&aoapps_mngr_voidapp);
 }
 
 
 // === app registration ======================================================
 
 
-typedef struct aoapps_mngr_app_s {
-  const char *        name;  // the (short) name of the app (identifier)
-  const char *        oled;  // the (long) name of the app for on the OLED (spaces and caps allowed)
-  const char *        xlbl;  // the label (function) for the x-button
-  const char *        ylbl;  // the label (function) for the y-button
-  int                 flags; // indicate if topo and or repair should be run by mngr
-  aoapps_mngr_start_t start; // reset app state machine to the starting state
-  aoapps_mngr_step_t  step;  // step the app state machine
-  aoapps_mngr_stop_t  stop;  // shutdown the app state machine (eg signaling LEDs)
-  aoapps_mngr_cmd_t   cmd;   // plugin for 'apps config' if an app has configuration needs
-  const char *        help;  // help text for configuration
- } aoapps_mngr_app_t;
+// The registry grows (doubles its capacity) when more apps are registered.
+// Besides registration order (appix), apps are indexed by name (sorted), 
+// so that a name (prefix) is found with a binary search.
 
 
-// All app descriptors
+// All app descriptors (registered apps point to their own, typically constexpr, descriptor)
 static int aoapps_mngr_count;
-static aoapps_mngr_app_t aoapps_mngr_apps[AOAPPS_MNGR_REGISTRATION_SLOTS] = {};
+static int aoapps_mngr_capacity;
+static const aoapps_mngr_app_t ** aoapps_mngr_apps;
+// Per app: was suspended (instead of stopped), so it may resume (instead of start)
+static int * aoapps_mngr_suspended;
+// Per app: the descriptor was allocated by aoapps_mngr_register(), so it is freed by aoapps_mngr_init()
+static uint8_t * aoapps_mngr_owned;
+// The appix's of all apps, sorted on name
+static uint16_t * aoapps_mngr_byname;
+
+
+// Forward declaration; the statistics (per app) grow with the registry
+static void aoapps_mngr_stats_grow(int capacity);
+
+
+// Ensures the registry has room for one more app
+static void aoapps_mngr_grow() {
+  if( aoapps_mngr_count<aoapps_mngr_capacity ) return;
+  int capacity= aoapps_mngr_capacity==0 ? AOAPPS_MNGR_REGISTRATION_SLOTS : 2*aoapps_mngr_capacity;
+  aoapps_mngr_apps= (const aoapps_mngr_app_t **)realloc( aoapps_mngr_apps, capacity*sizeof(aoapps_mngr_apps[0]) );
+  aoapps_mngr_suspended= (int *)realloc( aoapps_mngr_suspended, capacity*sizeof(aoapps_mngr_suspended[0]) );
+  aoapps_mngr_owned= (uint8_t *)realloc( aoapps_mngr_owned, capacity*sizeof(aoapps_mngr_owned[0]) );
+  aoapps_mngr_byname= (uint16_t *)realloc( aoapps_mngr_byname, capacity*sizeof(aoapps_mngr_byname[0]) );
+  AORESULT_ASSERT( aoapps_mngr_apps!=0 && aoapps_mngr_suspended!=0 && aoapps_mngr_owned!=0 && aoapps_mngr_byname!=0 );
+  aoapps_mngr_stats_grow(capacity);
+  aoapps_mngr_capacity= capacity;
+}
+
+
+// Inserts app `appix` in the name index (keeping it sorted); asserts on duplicate names
+static void aoapps_mngr_byname_insert(int appix) {
+  const char * name= aoapps_mngr_apps[appix]->name;
+  int pos= appix; // the index has appix entries
+  while( pos>0 ) {
+    int cmp= strcmp( aoapps_mngr_apps[aoapps_mngr_byname[pos-1]]->name, name );
+    AORESULT_ASSERT( cmp!=0 ); // app name already registered
+    if( cmp<0 ) break;
+    aoapps_mngr_byname[pos]= aoapps_mngr_byname[pos-1];
+    pos--;
+  }
+  aoapps_mngr_byname[pos]= appix;
+}
 
 
 /*!
@@ -101,8 +143,8 @@ static aoapps_mngr_app_t aoapps_mngr_apps[AOAPPS_MNGR_REGISTRATION_SLOTS] = {};
             AOAPPS_MNGR_FLAGS_WITHTOPO    
               build topo map before starting the app
             AOAPPS_MNGR_FLAGS_WITHREPAIR  
-              periodically repairs the chain by broadcasting clrerror and 
-              goactive telegrams
+              periodically repairs the chain by sending clrerror and 
+              goactive telegrams (to nodes found not active, or broadcast)
             AOAPPS_MNGR_FLAGS_NEXTONERR
               when the app goes into error, the app manager will switch to 
               the next app (after a 10 seconds)
@@ -131,34 +173,104 @@ static aoapps_mngr_app_t aoapps_mngr_apps[AOAPPS_MNGR_REGISTRATION_SLOTS] = {};
             A help string for the cmd() command handler. It will be shown
             when the user has given the command "apps configure name",
             (where name matches the name during registration).
+    @param  suspend
+            Optional. When present, the app manager calls suspend() instead
+            of stop() when the user selects another app. Like stop(), it 
+            restores shared hardware (e.g. dim level), but the app keeps its 
+            own state (e.g. EEPROM content, found I/O-expander, cursor).
+    @param  resume
+            Optional. When the user selects a suspended app again, the app 
+            manager calls resume() instead of start(); it should repaint the 
+            LEDs from the kept state. For an app with topo, this only happens 
+            when the kept topo map is still valid (no rebuild was needed), 
+            otherwise start() is called.
+    @param  on_button
+            Optional. When present, the app manager delivers the events of 
+            the X and Y buttons to on_button(but,event): a press, repeats 
+            every AOAPPS_MNGR_BUTTON_REPEATMS while the button is down, and 
+            a release. The handler is called in the app's step, before step().
+            An app without this handler polls aoui32 in its step() itself.
     @note   Might assert when too many apps are registered or when an 
             app registers with e.g. an illegal name.
     @note   It is optional to have a command handler. Either `cmd` and `help`
             are both 0 (no plugin) or both have a real value. `flags` can be
-            AOAPPS_MNGR_FLAGS_NONE (which is 0). All other registration 
+            AOAPPS_MNGR_FLAGS_NONE (which is 0). Also `suspend` and `resume`
+            are both 0 or both have a real value. All other registration 
             parameters are mandatory (can not be 0).
+    @note   The descriptor is copied into (heap) RAM; it is freed again by
+            `aoapps_mngr_init()`. Preferably use `aoapps_mngr_register_app()` 
+            with a constexpr descriptor, or `aoapps_mngr_register_table()`.
 */
-void aoapps_mngr_register(const char * name, const char * oled, const char * xlbl, const char * ylbl, int flags, aoapps_mngr_start_t start, aoapps_mngr_step_t step, aoapps_mngr_stop_t stop, aoapps_mngr_cmd_t cmd, const char * help) {
-  AORESULT_ASSERT( aoapps_mngr_count<AOAPPS_MNGR_REGISTRATION_SLOTS );
-  AORESULT_ASSERT( name!=0 && oled!=0 && xlbl!=0 && ylbl!=0 && start!=0 && step!=0 && stop!=0 );
-  AORESULT_ASSERT( (cmd==0) == (help==0) );
-  AORESULT_ASSERT( 0==(flags & ~AOAPPS_MNGR_FLAGS_ALL) );
-  for( const char *app_name_char=name; *app_name_char!=0; app_name_char++ ) 
-    AORESULT_ASSERT( isalnum(*app_name_char) ); // illegal char in app name
-  
+void aoapps_mngr_register(const char * name, const char * oled, const char * xlbl, const char * ylbl, int flags, aoapps_mngr_start_t start, aoapps_mngr_step_t step, aoapps_mngr_stop_t stop, aoapps_mngr_cmd_t cmd, const char * help, aoapps_mngr_suspend_t suspend, aoapps_mngr_resume_t resume, aoapps_mngr_button_t on_button) {
+  aoapps_mngr_app_t * app= (aoapps_mngr_app_t *)malloc( sizeof(aoapps_mngr_app_t) );
+  AORESULT_ASSERT( app!=0 );
+  app->name = name;
+  app->oled = oled;
+  app->xlbl = xlbl;
+  app->ylbl = ylbl;
+  app->flags= flags;
+  app->start= start;
+  app->step = step;
+  app->stop = stop;
+  app->cmd  = cmd;
+  app->help = help;
+  app->suspend= suspend;
+  app->resume = resume;
+  app->on_button= on_button;
+  aoapps_mngr_register_app(app);
+  aoapps_mngr_owned[aoapps_mngr_count-1]= 1;
+}
+
+
+// Adds app (a descriptor that is already checked) in the next slot of the registry
+static void aoapps_mngr_register_slot(const aoapps_mngr_app_t * app) {
+  AORESULT_ASSERT( aoapps_mngr_count<UINT16_MAX );
+  aoapps_mngr_grow();
   int slot = aoapps_mngr_count;
+  aoapps_mngr_apps[slot]= app;
+  aoapps_mngr_suspended[slot]= 0;
+  aoapps_mngr_owned[slot]= 0;
+  aoapps_mngr_byname_insert(slot);
   aoapps_mngr_count++;
-  
-  aoapps_mngr_apps[slot].name = name;
-  aoapps_mngr_apps[slot].oled = oled;
-  aoapps_mngr_apps[slot].xlbl = xlbl;
-  aoapps_mngr_apps[slot].ylbl = ylbl;
-  aoapps_mngr_apps[slot].flags= flags;
-  aoapps_mngr_apps[slot].start= start;
-  aoapps_mngr_apps[slot].step = step;
-  aoapps_mngr_apps[slot].stop = stop;
-  aoapps_mngr_apps[slot].cmd  = cmd;
-  aoapps_mngr_apps[slot].help = help;
+}
+
+
+/*!
+    @brief  Registers an app with the app manager, by passing its descriptor.
+    @param  app
+            The descriptor of the app; see `aoapps_mngr_register()` for the
+            meaning of the fields. The descriptor is not copied, so it must
+            be static. Preferably it is constexpr, so that it is stored in
+            flash and can be checked at compile time with 
+            `static_assert( aoapps_mngr_app_ok(desc), "..." )`.
+    @note   Might assert when out of memory or when the descriptor is 
+            illegal (e.g. an illegal name, or a name already registered).
+    @note   See `AOAPPS_MNGR_TABLE()` and `aoapps_mngr_register_table()` 
+            to declare and register several apps at once.
+*/
+void aoapps_mngr_register_app(const aoapps_mngr_app_t * app) {
+  AORESULT_ASSERT( app!=0 && aoapps_mngr_app_ok(*app) );
+  aoapps_mngr_register_slot(app);
+}
+
+
+/*!
+    @brief  Registers all apps in a table with the app manager.
+    @param  table
+            An array of app descriptors, preferably declared with 
+            `AOAPPS_MNGR_TABLE()`. The descriptors are not copied, so the 
+            table must be static.
+    @param  count
+            The number of descriptors in `table`.
+    @note   Unlike `aoapps_mngr_register_app()`, the descriptors are not 
+            checked at run time; `AOAPPS_MNGR_TABLE()` checks them at 
+            compile time. Typically called as `aoapps_mngr_register_table(table)`,
+            which infers `count`.
+    @note   Might assert when out of memory or when a name is already 
+            registered.
+*/
+void aoapps_mngr_register_table(const aoapps_mngr_app_t * table, int count) {
+  for( int ix=0; ix<count; ix++ ) aoapps_mngr_register_slot(&table[ix]);
 }
 
 
@@ -168,12 +280,27 @@ void aoapps_mngr_register(const char * name, const char * oled, const char * xlb
 // Forward declarations when the manager is flagged to run topo build
 static aoresult_t aoapps_mngr_startwithtopo();
 static aoresult_t aoapps_mngr_stepwithtopo();
+static int        aoapps_mngr_topoready();
+static int        aoapps_mngr_animating();
+// Forward declaration of the repair state machine reset
+static void       aoapps_mngr_repair_reset();
+// Forward declarations of the wrappers that collect statistics
+static aoresult_t aoapps_mngr_stats_start();
+static aoresult_t aoapps_mngr_stats_step();
+static void       aoapps_mngr_stats_overrun();
 
 
 // Flash frequency of the green signaling LED ("heartbeat" of the app)
 #define AOAPPS_MNGR_HEARTBEAT_MS 500
-// Time (in ms) between two repair steps
-#define AOAPPS_MNGR_REPAIR_MS  250
+// Time (in ms) between two repair steps; backs off to AOAPPS_MNGR_REPAIR_MAXMS while the chain is healthy
+#define AOAPPS_MNGR_REPAIR_MS     250
+#define AOAPPS_MNGR_REPAIR_MAXMS 2000
+// Number of nodes whose status is read per repair step
+#define AOAPPS_MNGR_REPAIR_SAMPLES  2
+// Maximum time (in ms) to sample all nodes once; on long chains this shortens the interval between repair steps
+#define AOAPPS_MNGR_REPAIR_ROUNDMS 2000
+// Maximum number of status reads per second; the same as the broadcast repair costs (2 telegrams every AOAPPS_MNGR_REPAIR_MS)
+#define AOAPPS_MNGR_REPAIR_MAXSPS  (2*1000/AOAPPS_MNGR_REPAIR_MS)
 // Timeout (in ms) for an error (to go to next app
 #define AOAPPS_MNGR_ERROR_MS  10000
 
@@ -198,6 +325,9 @@ static uint32_t   aoapps_mngr_lasterror;  // last time an error was detected
             First register some apps, then call aoapps_mngr_start().
 */            
 void aoapps_mngr_init() {
+  // Free the descriptors copied by aoapps_mngr_register() (re-init)
+  for( int appix=0; appix<aoapps_mngr_count; appix++ ) 
+    if( aoapps_mngr_owned[appix] ) free( (void *)aoapps_mngr_apps[appix] );
   aoapps_mngr_count= 0;
   aoapps_mngr_appix= 0;
   aoapps_mngr_moderun= 0;
@@ -207,6 +337,8 @@ void aoapps_mngr_init() {
   aoapps_mngr_lastgrn= millis();
   aoapps_mngr_lastrepair= millis();
   aoapps_mngr_lasterror= millis();
+  aoapps_mngr_repair_reset();
+  aoapps_mngr_stats_reset();
 }
 
 
@@ -219,7 +351,7 @@ static void aoapps_mngr_showstatus() {
     aoui32_led_off(AOUI32_LED_GRN);
     aoui32_led_on (AOUI32_LED_RED); 
     // Also on Serial
-    Serial.printf("apps: ERROR in app '%s': %s\n", aoapps_mngr_apps[aoapps_mngr_appix].name, aoresult_to_str(aoapps_mngr_result) );
+    Serial.printf("apps: ERROR in app '%s': %s\n", aoapps_mngr_apps[aoapps_mngr_appix]->name, aoresult_to_str(aoapps_mngr_result) );
     // Also show on OLED
     aoui32_oled_msg( aoresult_to_str(aoapps_mngr_result,1) );
     return;
@@ -233,21 +365,457 @@ static void aoapps_mngr_showstatus() {
 }
 
 
-// Just in case there was and error (under voltage) broadcast clrerror and goactive
-static aoresult_t aoapps_mngr_repair() {
+// === repair ================================================================
+// Nodes may go into error (e.g. under voltage) and then switch off their LEDs.
+// When there is a topo map, the manager reads the status of a few nodes per 
+// repair step (round robin). The typical fault, an under voltage event, puts 
+// all nodes in SLEEP, so the first node found not active triggers a broadcast
+// of clrerror and goactive, and the round restarts to verify. A node that is 
+// still not active after the broadcast (in the same round) has an isolated 
+// fault; it gets its own clrerror and goactive. While the chain is healthy, 
+// the repair interval backs off, but a round never takes longer than 
+// AOAPPS_MNGR_REPAIR_ROUNDMS. Sampling is capped at AOAPPS_MNGR_REPAIR_MAXSPS
+// reads per second, the cost of the broadcast repair. When a round would need
+// more than that (long chains), or without a topo map, the manager just 
+// broadcasts (every AOAPPS_MNGR_REPAIR_MS).
+
+
+static uint32_t aoapps_mngr_repair_ms;          // current (backed off) interval (in ms) between repair steps
+static uint16_t aoapps_mngr_repair_addr;        // next node to sample (round robin)
+static int      aoapps_mngr_repair_healthy;     // no repair was needed in the current round
+static int      aoapps_mngr_repair_broadcasted; // a broadcast was sent in the current round
+static uint32_t aoapps_mngr_repair_nodes;       // statistics: number of nodes repaired
+static uint32_t aoapps_mngr_repair_broadcasts;  // statistics: number of broadcast repairs
+
+
+// Resets the repair state machine (fast interval, start at first node)
+static void aoapps_mngr_repair_reset() {
+  aoapps_mngr_repair_ms= AOAPPS_MNGR_REPAIR_MS;
+  aoapps_mngr_repair_addr= 1;
+  aoapps_mngr_repair_healthy= 1;
+  aoapps_mngr_repair_broadcasted= 0;
+}
+
+
+// Returns 1 iff the repair samples node status; that needs a topo map, and a round within AOAPPS_MNGR_REPAIR_ROUNDMS must not exceed AOAPPS_MNGR_REPAIR_MAXSPS
+static int aoapps_mngr_repair_sampling() {
+  if( !aoapps_mngr_topoready() || aomw_topo_numnodes()==0 ) return 0;
+  return (uint32_t)aomw_topo_numnodes() * 1000 <= (uint32_t)AOAPPS_MNGR_REPAIR_MAXSPS * AOAPPS_MNGR_REPAIR_ROUNDMS;
+}
+
+
+// Returns the interval (in ms) between repair steps: the backed off interval, capped so that a round takes at most AOAPPS_MNGR_REPAIR_ROUNDMS
+static uint32_t aoapps_mngr_repair_intervalms() {
+  if( !aoapps_mngr_repair_sampling() ) return AOAPPS_MNGR_REPAIR_MS;
+  uint32_t ms= aoapps_mngr_repair_ms;
+  uint32_t roundms= (uint32_t)AOAPPS_MNGR_REPAIR_ROUNDMS * AOAPPS_MNGR_REPAIR_SAMPLES / aomw_topo_numnodes();
+  return ms<roundms ? ms : roundms;
+}
+
+
+// Broadcasts clrerror and goactive (repairs all nodes, without knowing which need it)
+static aoresult_t aoapps_mngr_repair_broadcast() {
   aoresult_t result;
+  result= aoosp_send_clrerror(0x000);
+  if( result!=aoresult_ok ) return result;
+  result=aoosp_send_goactive(0x000);
+  if( result!=aoresult_ok ) return result;
+  aoapps_mngr_repair_broadcasts++;
+  return aoresult_ok;
+}
+
+
+// Reads the status of the next AOAPPS_MNGR_REPAIR_SAMPLES nodes; the first one not active triggers a broadcast, later ones a unicast repair
+static aoresult_t aoapps_mngr_repair_sample() {
+  aoresult_t result;
+  uint16_t numnodes= aomw_topo_numnodes();
+  for( int sample=0; sample<AOAPPS_MNGR_REPAIR_SAMPLES && sample<numnodes; sample++ ) {
+    uint16_t addr= aoapps_mngr_repair_addr;
+    uint8_t  stat;
+    int      answered= aoosp_send_readstat(addr, &stat)==aoresult_ok;
+    if( !answered || (stat & AOOSP_STAT_STATE_MASK) != AOOSP_STAT_STATE_ACTIVE ) {
+      aoapps_mngr_repair_healthy= 0;
+      aoapps_mngr_repair_ms= AOAPPS_MNGR_REPAIR_MS; // a repair makes us look again soon
+      if( !answered || !aoapps_mngr_repair_broadcasted ) {
+        // Probably all nodes are hit (or this one lost its address): broadcast, and verify in a new round
+        result= aoapps_mngr_repair_broadcast();
+        if( result!=aoresult_ok ) return result;
+        aoapps_mngr_repair_broadcasted= 1;
+        aoapps_mngr_repair_addr= 1;
+        return aoresult_ok;
+      }
+      // Still not active after the broadcast: an isolated fault, repair this node only
+      result= aoosp_send_clrerror(addr);
+      if( result!=aoresult_ok ) return result;
+      result= aoosp_send_goactive(addr);
+      if( result!=aoresult_ok ) return result;
+      aoapps_mngr_repair_nodes++;
+    }
+    // Next node; at the end of a round, adapt the interval
+    aoapps_mngr_repair_addr++;
+    if( aoapps_mngr_repair_addr>numnodes ) {
+      aoapps_mngr_repair_addr= 1;
+      if( aoapps_mngr_repair_healthy ) {
+        aoapps_mngr_repair_ms*= 2;
+        if( aoapps_mngr_repair_ms>AOAPPS_MNGR_REPAIR_MAXMS ) aoapps_mngr_repair_ms= AOAPPS_MNGR_REPAIR_MAXMS;
+      }
+      aoapps_mngr_repair_healthy= 1;
+      aoapps_mngr_repair_broadcasted= 0;
+    }
+  }
+  return aoresult_ok;
+}
+
+
+// Just in case there was and error (under voltage) repair nodes that are not active
+static aoresult_t aoapps_mngr_repair() {
   // Is it time for a repair step?
-  if( millis()-aoapps_mngr_lastrepair > AOAPPS_MNGR_REPAIR_MS ) {
-    result= aoosp_send_clrerror(0x000);
-    if( result!=aoresult_ok ) return result;
-    result=aoosp_send_goactive(0x000);
-    if( result!=aoresult_ok ) return result;
-    aoapps_mngr_lastrepair = millis();
+  if( millis()-aoapps_mngr_lastrepair <= aoapps_mngr_repair_intervalms() ) return aoresult_ok;
+  aoapps_mngr_lastrepair = millis();
+  // Without topo map we do not know the nodes, and on long chains sampling costs more; broadcast
+  if( !aoapps_mngr_repair_sampling() ) return aoapps_mngr_repair_broadcast();
+  return aoapps_mngr_repair_sample();
+}
+
+
+// === budget ================================================================
+// The main loop must stay responsive (heartbeat, buttons, command interpreter).
+// Every call to aoapps_mngr_step() has a time budget. Apps that have much
+// work (e.g. many telegrams) can ask how much of the budget is left, and
+// postpone the remainder to a next step. Overruns are counted and logged.
+
+
+// Soft deadline (in us) for one aoapps_mngr_step()
+#define AOAPPS_MNGR_BUDGET_US       10000
+// Minimal time (in ms) between two overrun logs
+#define AOAPPS_MNGR_BUDGET_LOGMS     1000
+
+
+static uint32_t aoapps_mngr_budget_us0;    // time stamp (in us) of the start of the current aoapps_mngr_step()
+static uint32_t aoapps_mngr_budget_logms;  // time stamp (in ms) of the last overrun log
+static uint32_t aoapps_mngr_budget_unlogged; // number of overruns since the last overrun log
+
+
+/*!
+    @brief  Returns the remaining time budget of the current step.
+    @return The time (in us) left of the budget AOAPPS_MNGR_BUDGET_US
+            of the current `aoapps_mngr_step()`; 0 when exhausted.
+    @note   Apps that have much work to do in a step (e.g. sending 
+            telegrams to all nodes) can use this to spread the work over
+            multiple steps. Typically, an app does at least one unit of 
+            work per step, and continues while there is budget left.
+*/
+uint32_t aoapps_mngr_budget_left() {
+  uint32_t used= micros()-aoapps_mngr_budget_us0;
+  return used>=AOAPPS_MNGR_BUDGET_US ? 0 : AOAPPS_MNGR_BUDGET_US-used;
+}
+
+
+// Checks if the step (which started at aoapps_mngr_budget_us0) overran its budget, and if so logs that (rate limited)
+static void aoapps_mngr_budget_check() {
+  uint32_t used= micros()-aoapps_mngr_budget_us0;
+  if( used<=AOAPPS_MNGR_BUDGET_US ) return;
+  aoapps_mngr_stats_overrun();
+  aoapps_mngr_budget_unlogged++;
+  if( millis()-aoapps_mngr_budget_logms < AOAPPS_MNGR_BUDGET_LOGMS ) return;
+  Serial.printf("apps: step of '%s' took %lu us (budget %d us, %lu overruns)\n", aoapps_mngr_apps[aoapps_mngr_appix]->name, 
+    (unsigned long)used, AOAPPS_MNGR_BUDGET_US, (unsigned long)aoapps_mngr_budget_unlogged );
+  aoapps_mngr_budget_logms= millis();
+  aoapps_mngr_budget_unlogged= 0;
+}
+
+
+// === buttons ===============================================================
+// The sketch (or the task) scans the aoui32 buttons once per loop. For apps
+// with an on_button handler, the manager turns the scan results for X and Y 
+// into press, repeat and release events, so that apps do not each poll the 
+// buttons and implement auto-repeat.
+
+
+// Time (in ms) between two repeat events while a button is held down
+#define AOAPPS_MNGR_BUTTON_REPEATMS 200
+
+
+static const int aoapps_mngr_button_buts[]= { AOUI32_BUT_X, AOUI32_BUT_Y };
+#define AOAPPS_MNGR_BUTTON_NUM ( (int)(sizeof aoapps_mngr_button_buts / sizeof aoapps_mngr_button_buts[0]) )
+static int      aoapps_mngr_button_held;                         // mask of buttons whose press was delivered (and not yet released)
+static uint32_t aoapps_mngr_button_ms[AOAPPS_MNGR_BUTTON_NUM];   // time stamp of the last press or repeat of each button
+
+
+// Forgets held buttons (a new app only gets a repeat or release after its own press)
+static void aoapps_mngr_button_reset() {
+  aoapps_mngr_button_held= 0;
+}
+
+
+// Delivers the button events (since the last scan) to the on_button of the current app (if any)
+static aoresult_t aoapps_mngr_button_dispatch() {
+  aoapps_mngr_button_t on_button= aoapps_mngr_apps[aoapps_mngr_appix]->on_button;
+  if( on_button==0 ) return aoresult_ok;
+  for( int bix=0; bix<AOAPPS_MNGR_BUTTON_NUM; bix++ ) {
+    int but= aoapps_mngr_button_buts[bix];
+    int event= 0;
+    if( aoui32_but_wentdown(but) ) {
+      aoapps_mngr_button_held|= but;
+      aoapps_mngr_button_ms[bix]= millis();
+      event= AOAPPS_MNGR_BUTTON_PRESS;
+    } else if( aoapps_mngr_button_held & but ) {
+      if( !aoui32_but_isdown(but) ) {
+        aoapps_mngr_button_held&= ~but;
+        event= AOAPPS_MNGR_BUTTON_RELEASE;
+      } else if( millis()-aoapps_mngr_button_ms[bix] >= AOAPPS_MNGR_BUTTON_REPEATMS ) {
+        aoapps_mngr_button_ms[bix]= millis();
+        event= AOAPPS_MNGR_BUTTON_REPEAT;
+      }
+    }
+    if( event ) {
+      aoresult_t result= on_button(but,event);
+      if( result!=aoresult_ok ) return result;
+    }
   }
   return aoresult_ok;
 }
 
 
+// Returns the time stamp (in ms) of the next repeat event; only valid when aoapps_mngr_button_held
+static uint32_t aoapps_mngr_button_duems() {
+  uint32_t due= 0;
+  int first= 1;
+  for( int bix=0; bix<AOAPPS_MNGR_BUTTON_NUM; bix++ ) {
+    if( !(aoapps_mngr_button_held & aoapps_mngr_button_buts[bix]) ) continue;
+    uint32_t ms= aoapps_mngr_button_ms[bix]+AOAPPS_MNGR_BUTTON_REPEATMS;
+    if( first || (int32_t)(ms-due)<0 ) due= ms;
+    first= 0;
+  }
+  return due;
+}
+
+
+// === idle ==================================================================
+// Most steps of most apps only check millis() and return. An app can tell 
+// the manager when it next has work (its wake-up time). The manager combines
+// that with its own deadlines (heartbeat, repair), so that the sketch can 
+// sleep (or yield) in loop() until there is work again.
+
+
+// Maximum idle time (in ms); keeps polling of buttons and Serial responsive
+#define AOAPPS_MNGR_IDLE_MAXMS  20
+
+
+static int      aoapps_mngr_wakeup_valid; // the app passed a wake-up time in its last step
+static uint32_t aoapps_mngr_wakeup_ms;    // the wake-up time (in millis() time) passed by the app
+static uint32_t aoapps_mngr_idle_steps;   // statistics: number of steps
+static uint32_t aoapps_mngr_idle_early;   // statistics: number of steps before there was work (wasted wake-ups)
+
+
+/*!
+    @brief  Apps call this function from their step() to tell the manager
+            when they have work again (typically the next animation frame).
+    @param  ms
+            The wake-up time, as absolute time stamp in `millis()` time.
+    @note   The wake-up time is only valid until the next step; an app 
+            that does not call this function in a step, is assumed to 
+            have work in every step (and the sketch will not be idle).
+    @note   An app typically calls this with something like
+            `aoapps_mngr_wakeup_at(lastms+ANIM_MS)`.
+    @note   Buttons (and Serial) are still polled every AOAPPS_MNGR_IDLE_MAXMS
+            ms, so the wake-up time does not need to take those into account.
+    @note   Does nothing when the manager is not initialized (an app that 
+            runs standalone, see example aoapps_runled.ino).
+*/
+void aoapps_mngr_wakeup_at(uint32_t ms) {
+  if( aoapps_mngr_count==0 ) return;
+  aoapps_mngr_wakeup_valid= 1;
+  aoapps_mngr_wakeup_ms= ms;
+}
+
+
+// Returns the time (in ms) from now till `deadline` (0 when passed)
+static uint32_t aoapps_mngr_idle_till(uint32_t deadline) {
+  int32_t ms= (int32_t)(deadline-millis());
+  return ms<0 ? 0 : ms;
+}
+
+
+/*!
+    @brief  Returns the time until the manager has work again.
+    @return The time (in ms) the sketch may sleep before calling 
+            `aoapps_mngr_step()` again. Never more than AOAPPS_MNGR_IDLE_MAXMS. 
+            Returns 0 when there is work now, or when the current app did
+            not pass a wake-up time (see `aoapps_mngr_wakeup_at()`).
+    @note   Combines the wake-up time of the app with the deadlines of the 
+            manager itself (heartbeat and repair).
+    @note   Typical use is `delay( aoapps_mngr_idle_ms() )` at the end of 
+            loop(); on ESP32 `delay()` yields to other tasks, and allows the 
+            idle task to light sleep (when power management is enabled).
+*/
+uint32_t aoapps_mngr_idle_ms() {
+  if( !aoapps_mngr_moderun ) return 0;
+  // App stopped stepping due to an error; only the (slow) NEXTONERR timeout is pending
+  if( aoapps_mngr_result!=aoresult_ok ) return AOAPPS_MNGR_IDLE_MAXMS;
+  // App did not tell when it has work (or app is not yet stepped, e.g. topo build)
+  if( !aoapps_mngr_wakeup_valid ) return 0;
+  uint32_t idle= AOAPPS_MNGR_IDLE_MAXMS;
+  uint32_t ms;
+  ms= aoapps_mngr_idle_till(aoapps_mngr_wakeup_ms);
+  if( ms<idle ) idle= ms;
+  ms= aoapps_mngr_idle_till(aoapps_mngr_lastgrn+AOAPPS_MNGR_HEARTBEAT_MS+1);
+  if( ms<idle ) idle= ms;
+  if( aoapps_mngr_button_held ) {
+    ms= aoapps_mngr_idle_till(aoapps_mngr_button_duems());
+    if( ms<idle ) idle= ms;
+  }
+  if( aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_WITHREPAIR ) {
+    ms= aoapps_mngr_idle_till(aoapps_mngr_lastrepair+aoapps_mngr_repair_intervalms()+1);
+    if( ms<idle ) idle= ms;
+  }
+  return idle;
+}
+
+
+// === task ==================================================================
+// Optionally, the app manager steps the apps in a dedicated FreeRTOS task, 
+// pinned to a core. Then a long command or Serial print in loop() no longer 
+// stalls animation frames. Commands that change the app (switch, config) 
+// are not executed by the loop() task, but posted in a queue, which is 
+// drained by the animation task between two steps. The queue is lock-free,
+// with one producer (the loop() task) and one consumer (the animation task).
+
+
+// Number of entries in the command queue (must be a power of 2)
+#define AOAPPS_MNGR_QUEUE_SIZE      8
+// Size of the buffer in a queue entry (holds the arguments of a config command)
+#define AOAPPS_MNGR_QUEUE_BUFSIZE  96
+// Maximum number of arguments of a config command in the queue
+#define AOAPPS_MNGR_QUEUE_MAXARGS  12
+// Stack size (in bytes) of the animation task
+#define AOAPPS_MNGR_TASK_STACK   8192
+
+
+// The operations in a queue entry
+#define AOAPPS_MNGR_QUEUE_OP_SWITCH      1
+#define AOAPPS_MNGR_QUEUE_OP_SWITCHNEXT  2
+#define AOAPPS_MNGR_QUEUE_OP_CONFIG      3
+#define AOAPPS_MNGR_QUEUE_OP_STATSRESET  4
+
+
+typedef struct aoapps_mngr_queue_entry_s {
+  int  op;    // one of AOAPPS_MNGR_QUEUE_OP_XXX
+  int  appix; // app to switch to respectively app to configure (not used for switchnext and statsreset)
+  int  argc;  // config only: number of arguments in buf
+  char buf[AOAPPS_MNGR_QUEUE_BUFSIZE]; // config only: argc zero-terminated arguments
+} aoapps_mngr_queue_entry_t;
+
+
+static aoapps_mngr_queue_entry_t aoapps_mngr_queue[AOAPPS_MNGR_QUEUE_SIZE];
+static uint32_t     aoapps_mngr_queue_head;  // next entry to write; only written by producer
+static uint32_t     aoapps_mngr_queue_tail;  // next entry to read; only written by consumer
+static TaskHandle_t aoapps_mngr_task_handle; // the animation task (0 when apps are stepped from loop())
+
+
+// Returns 1 when the animation task is running, and the caller is another task (so it must post)
+static int aoapps_mngr_task_isother() {
+  return aoapps_mngr_task_handle!=0 && xTaskGetCurrentTaskHandle()!=aoapps_mngr_task_handle;
+}
+
+
+// Producer: returns 1 when the queue is full (a next post fails); a 0 stays valid, since only the consumer frees entries
+static int aoapps_mngr_queue_isfull() {
+  uint32_t tail= __atomic_load_n(&aoapps_mngr_queue_tail, __ATOMIC_ACQUIRE);
+  return aoapps_mngr_queue_head-tail==AOAPPS_MNGR_QUEUE_SIZE;
+}
+
+
+// Producer: appends an entry to the queue; copies argv (config only). Returns 0 if queue is full or args too long.
+static int aoapps_mngr_queue_post(int op, int appix, int argc, char * argv[]) {
+  uint32_t head= aoapps_mngr_queue_head;
+  if( aoapps_mngr_queue_isfull() ) { Serial.printf("ERROR: apps queue full\n"); return 0; }
+  if( argc>AOAPPS_MNGR_QUEUE_MAXARGS ) { Serial.printf("ERROR: too many args\n"); return 0; }
+  aoapps_mngr_queue_entry_t * entry= &aoapps_mngr_queue[head % AOAPPS_MNGR_QUEUE_SIZE];
+  entry->op= op;
+  entry->appix= appix;
+  entry->argc= argc;
+  int pos= 0;
+  for( int i=0; i<argc; i++ ) {
+    int len= strlen(argv[i])+1;
+    if( pos+len>AOAPPS_MNGR_QUEUE_BUFSIZE ) { Serial.printf("ERROR: args too long\n"); return 0; }
+    memcpy(&entry->buf[pos], argv[i], len);
+    pos+= len;
+  }
+  // Publish the entry (release: entry content is visible before the new head)
+  __atomic_store_n(&aoapps_mngr_queue_head, head+1, __ATOMIC_RELEASE);
+  return 1;
+}
+
+
+// Consumer: executes all queued entries (called by the animation task between steps)
+static void aoapps_mngr_queue_drain() {
+  uint32_t tail= aoapps_mngr_queue_tail;
+  uint32_t head= __atomic_load_n(&aoapps_mngr_queue_head, __ATOMIC_ACQUIRE);
+  while( tail!=head ) {
+    aoapps_mngr_queue_entry_t * entry= &aoapps_mngr_queue[tail % AOAPPS_MNGR_QUEUE_SIZE];
+    if( entry->op==AOAPPS_MNGR_QUEUE_OP_SWITCH ) {
+      aoapps_mngr_switch(entry->appix);
+    } else if( entry->op==AOAPPS_MNGR_QUEUE_OP_SWITCHNEXT ) {
+      aoapps_mngr_switchnext();
+    } else if( entry->op==AOAPPS_MNGR_QUEUE_OP_CONFIG ) {
+      char * argv[AOAPPS_MNGR_QUEUE_MAXARGS];
+      char * arg= entry->buf;
+      for( int i=0; i<entry->argc; i++ ) { argv[i]= arg; arg+= strlen(arg)+1; }
+      aoapps_mngr_apps[entry->appix]->cmd(entry->argc,argv);
+    } else if( entry->op==AOAPPS_MNGR_QUEUE_OP_STATSRESET ) {
+      aoapps_mngr_stats_reset();
+    }
+    tail++;
+    // Release the entry (release: we are done with its content before the producer may overwrite it)
+    __atomic_store_n(&aoapps_mngr_queue_tail, tail, __ATOMIC_RELEASE);
+  }
+}
+
+
+// The body of the animation task
+static void aoapps_mngr_task_main(void * param) {
+  (void)param;
+  while( 1 ) {
+    // Apply commands posted by loop()
+    aoapps_mngr_queue_drain();
+    // Check physical buttons; switch to next app when A was pressed
+    aoui32_but_scan();
+    if( aoui32_but_wentdown(AOUI32_BUT_A) ) aoapps_mngr_switchnext();
+    // Let current app progress
+    aoapps_mngr_step();
+    // Sleep until there is work again (at least one tick, so that lower priority tasks run)
+    uint32_t ticks= pdMS_TO_TICKS( aoapps_mngr_idle_ms() );
+    vTaskDelay( ticks>0 ? ticks : 1 );
+  }
+}
+
+
+/*!
+    @brief  Starts a dedicated task that steps the current app.
+    @param  core
+            The core the task is pinned to; on ESP32 loop() runs on core 1, 
+            so the default puts the animation on the other core.
+    @note   Call this at the end of setup(), after `aoapps_mngr_start()`.
+    @note   From then on, loop() must no longer call `aoapps_mngr_step()`
+            (that asserts), nor `aoui32_but_scan()`. The task scans the 
+            buttons and switches to the next app on button A, like 
+            the stock sketches do.
+    @note   `aoapps_mngr_switch()`, `aoapps_mngr_switchnext()` and the commands 
+            `apps switch` and `apps config` may still be used from loop(); 
+            they are posted in a queue and executed by the task between
+            two steps. There must be only one task posting: loop().
+    @note   The task owns the OSP chain; commands that send telegrams 
+            themselves (e.g. `osp`) should only be given when the voidapp runs.
+*/
+void aoapps_mngr_task_start(int core) {
+  AORESULT_ASSERT( aoapps_mngr_moderun );
+  AORESULT_ASSERT( aoapps_mngr_task_handle==0 );
+  BaseType_t res= xTaskCreatePinnedToCore(aoapps_mngr_task_main, "aoapps", AOAPPS_MNGR_TASK_STACK, 0, 1, &aoapps_mngr_task_handle, core);
+  AORESULT_ASSERT( res==pdPASS );
+}
+
+
 /*!
     @brief  Starts app with index `appix`.
             That is, set "current" app to `appix` and "run" it.
@@ -276,9 +844,9 @@ void aoapps_mngr_start(int appix) {
   AORESULT_ASSERT( 0<=appix && appix<aoapps_mngr_count );
   aoapps_mngr_appix= appix;
   // Update OLED with app name and button labels
-  aoui32_oled_state(aoapps_mngr_apps[aoapps_mngr_appix].oled, aoapps_mngr_apps[aoapps_mngr_appix].xlbl, aoapps_mngr_apps[aoapps_mngr_appix].ylbl);
+  aoui32_oled_state(aoapps_mngr_apps[aoapps_mngr_appix]->oled, aoapps_mngr_apps[aoapps_mngr_appix]->xlbl, aoapps_mngr_apps[aoapps_mngr_appix]->ylbl);
   // Print app name to serial
-  //Serial.printf("apps: start '%s'\n", aoapps_mngr_apps[aoapps_mngr_appix].name );
+  //Serial.printf("apps: start '%s'\n", aoapps_mngr_apps[aoapps_mngr_appix]->name );
   // Record new run mode
   aoapps_mngr_moderun=1;
   // Initialize signaling LEDs
@@ -286,11 +854,15 @@ void aoapps_mngr_start(int appix) {
   // Show first heartbeat
   aoui32_led_on(AOUI32_LED_GRN);
   aoapps_mngr_lastgrn= millis();
+  // Chain might be different for this app
+  aoapps_mngr_repair_reset();
   // Call start() function of the app
-  if( aoapps_mngr_apps[aoapps_mngr_appix].flags & AOAPPS_MNGR_FLAGS_WITHTOPO ) {
+  if( aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_WITHTOPO ) {
     aoapps_mngr_result= aoapps_mngr_startwithtopo();
   } else {
-    aoapps_mngr_result= aoapps_mngr_apps[aoapps_mngr_appix].start();
+    // This app might change the chain without the manager knowing it
+    aoapps_mngr_topo_invalidate();
+    aoapps_mngr_result= aoapps_mngr_stats_start();
   }
   // Show app status to user
   aoapps_mngr_showstatus();
@@ -312,26 +884,37 @@ void aoapps_mngr_start(int appix) {
 void aoapps_mngr_step() {
   // Current mode should be running
   AORESULT_ASSERT( aoapps_mngr_moderun );
+  // When there is an animation task, only that task steps
+  AORESULT_ASSERT( ! aoapps_mngr_task_isother() );
   // If there was an error in a previous step, do not step again
   if( aoapps_mngr_result!=aoresult_ok ) {
-    if( aoapps_mngr_apps[aoapps_mngr_appix].flags & AOAPPS_MNGR_FLAGS_NEXTONERR )
+    if( aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_NEXTONERR )
       if( millis()-aoapps_mngr_lasterror>AOAPPS_MNGR_ERROR_MS ) {
         Serial.printf("apps: this app switches to next after error\n");
         aoapps_mngr_switchnext();
       }
     return;
   }
+  // Count the steps that came before there was work (the sketch could have been idle)
+  aoapps_mngr_idle_steps++;
+  if( aoapps_mngr_idle_ms()>0 ) aoapps_mngr_idle_early++;
+  // The app passes a new wake-up time (if any) in this step
+  aoapps_mngr_wakeup_valid= 0;
+  // Start of the time budget for this step
+  aoapps_mngr_budget_us0= micros();
   // Call step() function of the underlying app.
-  if( aoapps_mngr_apps[aoapps_mngr_appix].flags & AOAPPS_MNGR_FLAGS_WITHTOPO ) {
+  if( aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_WITHTOPO ) {
     aoapps_mngr_result= aoapps_mngr_stepwithtopo();
   } else {
-    aoapps_mngr_result= aoapps_mngr_apps[aoapps_mngr_appix].step();
+    aoapps_mngr_result= aoapps_mngr_stats_step();
   }
   // Call repair
   if( aoapps_mngr_result==aoresult_ok ) 
-    if( aoapps_mngr_apps[aoapps_mngr_appix].flags & AOAPPS_MNGR_FLAGS_WITHREPAIR ) {
+    if( aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_WITHREPAIR ) {
       aoapps_mngr_result= aoapps_mngr_repair();
   }
+  // Check time budget
+  aoapps_mngr_budget_check();
   // Show app status to user
   aoapps_mngr_showstatus();
 }
@@ -344,12 +927,21 @@ void aoapps_mngr_step() {
     @note   This function is typically not called, rather 
             `aoapps_mngr_switch()` or `aoapps_mngr_switchnext()` is called
             which handles calling `stop()`.
+    @note   When the app registered suspend/resume handlers and runs without
+            error, its `suspend()` is called instead of `stop()`. A next 
+            start of that app then calls `resume()` instead of `start()`.
 */            
 void aoapps_mngr_stop() {
   // Current mode should be running
   AORESULT_ASSERT( aoapps_mngr_moderun );
-  // Call stop() function of the underlying app.
-  aoapps_mngr_apps[aoapps_mngr_appix].stop();
+  // Call suspend() (if the app has it and is animating without error), otherwise stop() of the underlying app.
+  if( aoapps_mngr_apps[aoapps_mngr_appix]->suspend && aoapps_mngr_animating() ) {
+    aoapps_mngr_apps[aoapps_mngr_appix]->suspend();
+    aoapps_mngr_suspended[aoapps_mngr_appix]= 1;
+  } else {
+    aoapps_mngr_apps[aoapps_mngr_appix]->stop();
+    aoapps_mngr_suspended[aoapps_mngr_appix]= 0;
+  }
   // Record new run mode
   aoapps_mngr_moderun=0;
 }
@@ -365,8 +957,11 @@ void aoapps_mngr_stop() {
     @note   aoapps_mngr_switch(0) will select the voidapp; the function
             aoapps_mngr_switchnext() skips the voidapp.
     @note   See `aoapps_mngr_switchnext()`.
+    @note   When called outside the animation task (see `aoapps_mngr_task_start()`)
+            the switch is posted, and executed by the task before its next step.
 */            
 void aoapps_mngr_switch(int appix) {
+  if( aoapps_mngr_task_isother() ) { aoapps_mngr_queue_post(AOAPPS_MNGR_QUEUE_OP_SWITCH, appix, 0, 0); return; }
   aoapps_mngr_stop();
   aoapps_mngr_start(appix);
 }
@@ -380,6 +975,7 @@ void aoapps_mngr_switch(int appix) {
     @note   See `aoapps_mngr_start()` for start/stop/current/appix terminology.
 */            
 void aoapps_mngr_switchnext() {
+  if( aoapps_mngr_task_isother() ) { aoapps_mngr_queue_post(AOAPPS_MNGR_QUEUE_OP_SWITCHNEXT, 0, 0, 0); return; }
   aoapps_mngr_switch( aoapps_mngr_appix % (aoapps_mngr_count-1) + 1);
 }
 
@@ -426,7 +1022,7 @@ int aoapps_mngr_app_count() {
     @note   See `aoapps_mngr_start()` for start/stop/current/appix terminology.
 */            
 const char * aoapps_mngr_app_name(int appix) {
-  return aoapps_mngr_apps[appix].name;
+  return aoapps_mngr_apps[appix]->name;
 }
 
 
@@ -438,7 +1034,275 @@ const char * aoapps_mngr_app_name(int appix) {
     @note   See `aoapps_mngr_start()` for start/stop/current/appix terminology.
 */            
 const char * aoapps_mngr_app_oled(int appix) {
-  return aoapps_mngr_apps[appix].oled;
+  return aoapps_mngr_apps[appix]->oled;
+}
+
+
+/*!
+    @brief  Finds the app with name `name`, or whose name starts with `name`.
+    @param  name
+            The (short) name of the app, or a prefix of it.
+    @return The application index of the found app, or 
+            AOAPPS_MNGR_FIND_NONE when no app matches, or
+            AOAPPS_MNGR_FIND_AMBIGUOUS when multiple apps start with `name`
+            (and none has exactly that name).
+    @note   Uses a binary search on the (sorted) name index, so the cost is 
+            O(log(count)*length(name)) instead of a scan over all apps.
+*/
+int aoapps_mngr_app_find(const char * name) {
+  int len= strlen(name);
+  // Find the first app (in name order) whose name is not less than `name`
+  int lo= 0;
+  int hi= aoapps_mngr_count;
+  while( lo<hi ) {
+    int mid= (lo+hi)/2;
+    if( strcmp(aoapps_mngr_apps[aoapps_mngr_byname[mid]]->name, name) < 0 ) lo= mid+1; else hi= mid;
+  }
+  // All names starting with `name` follow from there (an exact match comes first)
+  if( lo==aoapps_mngr_count ) return AOAPPS_MNGR_FIND_NONE;
+  const char * found= aoapps_mngr_apps[aoapps_mngr_byname[lo]]->name;
+  if( strncmp(found,name,len)!=0 ) return AOAPPS_MNGR_FIND_NONE;
+  if( found[len]==0 ) return aoapps_mngr_byname[lo];
+  if( lo+1<aoapps_mngr_count && strncmp(aoapps_mngr_apps[aoapps_mngr_byname[lo+1]]->name,name,len)==0 ) return AOAPPS_MNGR_FIND_AMBIGUOUS;
+  return aoapps_mngr_byname[lo];
+}
+
+
+// === statistics ============================================================
+// The manager wraps the start() and step() of the current app, to measure 
+// how long each step() takes. Apps report when a step() did actual work 
+// (e.g. painted a frame) via aoapps_mngr_stats_frame(). The manager also 
+// counts the OSP telegrams (from the aospi counters) sent and received by 
+// the app's start() and step(); the remaining telegrams are from the manager
+// (topo build and validation, repair) or from commands.
+
+
+// Number of buckets in the histogram of step() durations. Bucket 0 counts 
+// durations below AOAPPS_MNGR_STATS_US0, every next bucket doubles the upper
+// bound, and the last bucket counts all that remains.
+#define AOAPPS_MNGR_STATS_BUCKETS 12
+#define AOAPPS_MNGR_STATS_US0     8
+
+
+// Statistics of one app
+typedef struct aoapps_mngr_stats_s {
+  uint32_t steps;   // number of step() calls
+  uint32_t frames;  // number of step() calls that did work (see aoapps_mngr_stats_frame)
+  uint32_t runms;   // total time (in ms) the app was stepped; denominator for FPS
+  uint32_t overs;   // number of aoapps_mngr_step() calls that overran the time budget
+  uint32_t minus;   // shortest step() (in us)
+  uint32_t maxus;   // longest step() (in us)
+  uint64_t sumus;   // sum of all step() durations (in us)
+  uint32_t hist[AOAPPS_MNGR_STATS_BUCKETS]; // histogram of step() durations
+  uint32_t tx;      // number of telegrams sent by start() and step()
+  uint32_t rx;      // number of telegrams received by start() and step()
+  uint32_t txmax;   // most telegrams sent by one step()
+} aoapps_mngr_stats_t;
+
+
+static aoapps_mngr_stats_t * aoapps_mngr_stats; // one per app (grows with the registry)
+static int                   aoapps_mngr_stats_capacity;
+static uint32_t              aoapps_mngr_stats_lastms; // time stamp of last step (or start) of current app
+static int                   aoapps_mngr_stats_tx0;    // aospi tx counter at last reset (for telegrams not from apps)
+static int                   aoapps_mngr_stats_rx0;    // aospi rx counter at last reset
+
+
+// Grows the statistics array to `capacity` (new entries are cleared)
+static void aoapps_mngr_stats_grow(int capacity) {
+  aoapps_mngr_stats= (aoapps_mngr_stats_t *)realloc( aoapps_mngr_stats, capacity*sizeof(aoapps_mngr_stats_t) );
+  AORESULT_ASSERT( aoapps_mngr_stats!=0 );
+  memset( &aoapps_mngr_stats[aoapps_mngr_stats_capacity], 0, (capacity-aoapps_mngr_stats_capacity)*sizeof(aoapps_mngr_stats_t) );
+  aoapps_mngr_stats_capacity= capacity;
+}
+
+
+// Returns how far the aospi counter moved from `count0` to `count1` (0 when it went back, e.g. it was reset)
+static uint32_t aoapps_mngr_stats_delta(int count0, int count1) {
+  return count1>count0 ? count1-count0 : 0;
+}
+
+
+// Calls start() of the current app, and records the start as step time anchor
+static aoresult_t aoapps_mngr_stats_start() {
+  aoapps_mngr_stats_t * stats= &aoapps_mngr_stats[aoapps_mngr_appix];
+  int tx0= aospi_txcount_get();
+  int rx0= aospi_rxcount_get();
+  aoresult_t result;
+  aoapps_mngr_button_reset();
+  if( aoapps_mngr_suspended[aoapps_mngr_appix] ) result= aoapps_mngr_apps[aoapps_mngr_appix]->resume();
+  else result= aoapps_mngr_apps[aoapps_mngr_appix]->start();
+  aoapps_mngr_suspended[aoapps_mngr_appix]= 0;
+  stats->tx+= aoapps_mngr_stats_delta(tx0, aospi_txcount_get());
+  stats->rx+= aoapps_mngr_stats_delta(rx0, aospi_rxcount_get());
+  aoapps_mngr_stats_lastms= millis();
+  return result;
+}
+
+
+// Calls step() of the current app, and records its duration in the statistics
+static aoresult_t aoapps_mngr_stats_step() {
+  aoapps_mngr_stats_t * stats= &aoapps_mngr_stats[aoapps_mngr_appix];
+  int tx0= aospi_txcount_get();
+  int rx0= aospi_rxcount_get();
+  uint32_t us0= micros();
+  aoresult_t result= aoapps_mngr_button_dispatch();
+  if( result==aoresult_ok ) result= aoapps_mngr_apps[aoapps_mngr_appix]->step();
+  uint32_t us= micros()-us0;
+  // Update telegram statistics
+  uint32_t tx= aoapps_mngr_stats_delta(tx0, aospi_txcount_get());
+  stats->tx+= tx;
+  stats->rx+= aoapps_mngr_stats_delta(rx0, aospi_rxcount_get());
+  if( tx>stats->txmax ) stats->txmax= tx;
+  // Update duration statistics
+  if( stats->steps==0 || us<stats->minus ) stats->minus= us;
+  if( us>stats->maxus ) stats->maxus= us;
+  stats->sumus+= us;
+  stats->steps++;
+  int bucket= 0;
+  while( bucket<AOAPPS_MNGR_STATS_BUCKETS-1 && us>=((uint32_t)AOAPPS_MNGR_STATS_US0<<bucket) ) bucket++;
+  stats->hist[bucket]++;
+  // Update run time (for FPS)
+  uint32_t ms= millis();
+  stats->runms+= ms-aoapps_mngr_stats_lastms;
+  aoapps_mngr_stats_lastms= ms;
+  return result;
+}
+
+
+// Records that the current app overran the time budget of aoapps_mngr_step()
+static void aoapps_mngr_stats_overrun() {
+  aoapps_mngr_stats[aoapps_mngr_appix].overs++;
+}
+
+
+/*!
+    @brief  Apps call this function from their step() when that step did 
+            actual work, typically painting an animation frame.
+    @note   The app manager uses this to report how many steps did work,
+            and to compute the achieved frames-per-second of an app
+            (see command `apps stats`).
+    @note   Calling this function is optional, but without it, an app 
+            reports 0 FPS.
+    @note   Does nothing when the manager is not initialized (an app that 
+            runs standalone, see example aoapps_runled.ino).
+*/
+void aoapps_mngr_stats_frame() {
+  if( aoapps_mngr_count==0 ) return;
+  aoapps_mngr_stats[aoapps_mngr_appix].frames++;
+}
+
+
+/*!
+    @brief  Clears the step() statistics of all apps.
+    @note   Is called by `aoapps_mngr_init()` and by command `apps stats reset`.
+    @note   When called outside the animation task (see `aoapps_mngr_task_start()`)
+            the reset is posted, and executed by the task before its next step
+            (the task owns the statistics).
+*/
+void aoapps_mngr_stats_reset() {
+  if( aoapps_mngr_task_isother() ) { aoapps_mngr_queue_post(AOAPPS_MNGR_QUEUE_OP_STATSRESET, 0, 0, 0); return; }
+  memset( aoapps_mngr_stats, 0, aoapps_mngr_stats_capacity*sizeof(aoapps_mngr_stats_t) );
+  aoapps_mngr_stats_lastms= millis();
+  aoapps_mngr_stats_tx0= aospi_txcount_get();
+  aoapps_mngr_stats_rx0= aospi_rxcount_get();
+  aoapps_mngr_repair_nodes= 0;
+  aoapps_mngr_repair_broadcasts= 0;
+  aoapps_mngr_idle_steps= 0;
+  aoapps_mngr_idle_early= 0;
+}
+
+
+// === topo cache ============================================================
+// A topo build takes long on long chains. When an app with topo is followed
+// by another app with topo, the manager validates the existing topo map 
+// with a few telegrams, and only rebuilds it when validation fails.
+
+
+// Number of nodes whose ID is recorded, and checked on validation
+#define AOAPPS_MNGR_TOPOCACHE_PROBES 3
+
+
+static int      aoapps_mngr_topocache_valid;                               // the chain has not been touched since the topo build
+static uint16_t aoapps_mngr_topocache_numnodes;                            // chain length at topo build
+static uint16_t aoapps_mngr_topocache_addr[AOAPPS_MNGR_TOPOCACHE_PROBES];  // nodes whose ID is recorded
+static uint32_t aoapps_mngr_topocache_id[AOAPPS_MNGR_TOPOCACHE_PROBES];    // IDs of those nodes at topo build
+
+
+// Records the topo map just built (chain length and IDs of first, middle, and last node)
+static void aoapps_mngr_topocache_record() {
+  aoapps_mngr_topocache_valid= 0;
+  aoapps_mngr_topocache_numnodes= aomw_topo_numnodes();
+  if( aoapps_mngr_topocache_numnodes==0 ) return;
+  for( int pix=0; pix<AOAPPS_MNGR_TOPOCACHE_PROBES; pix++ ) {
+    uint16_t addr= 1 + (uint32_t)(aoapps_mngr_topocache_numnodes-1) * pix / (AOAPPS_MNGR_TOPOCACHE_PROBES-1);
+    aoapps_mngr_topocache_addr[pix]= addr;
+    if( aoosp_send_identify(addr, &aoapps_mngr_topocache_id[pix])!=aoresult_ok ) return;
+  }
+  aoapps_mngr_topocache_valid= 1;
+}
+
+
+// Returns 1 iff the chain still matches the recorded topo map
+static int aoapps_mngr_topocache_check() {
+  if( !aoapps_mngr_topocache_valid ) return 0;
+  if( aomw_topo_numnodes()!=aoapps_mngr_topocache_numnodes ) return 0;
+  // The probed nodes must still have their address and ID
+  for( int pix=0; pix<AOAPPS_MNGR_TOPOCACHE_PROBES; pix++ ) {
+    uint32_t id;
+    if( aoosp_send_identify(aoapps_mngr_topocache_addr[pix], &id)!=aoresult_ok ) return 0;
+    if( id!=aoapps_mngr_topocache_id[pix] ) return 0;
+  }
+  // There must be no node after the last one (chain length probe)
+  uint32_t id;
+  if( aoapps_mngr_topocache_numnodes<0x3EF && aoosp_send_identify(aoapps_mngr_topocache_numnodes+1, &id)==aoresult_ok ) return 0;
+  return 1;
+}
+
+
+// Activates all nodes and switches all triplets off (as a topo build would do), using broadcasts only
+static aoresult_t aoapps_mngr_topocache_clear() {
+  aoresult_t result;
+  // Nodes may have kept their address but dropped to SLEEP (e.g. under voltage)
+  result= aoosp_send_clrerror(0x000);
+  if( result!=aoresult_ok ) return result;
+  result= aoosp_send_goactive(0x000);
+  if( result!=aoresult_ok ) return result;
+  // The topo map (in RAM) tells which node types are present
+  int rgbi= 0, said= 0;
+  for( uint16_t addr=1; addr<=aomw_topo_numnodes(); addr++ ) {
+    uint32_t id= aomw_topo_node_id(addr);
+    if( AOOSP_IDENTIFY_IS_RGBI(id) ) rgbi= 1;
+    else if( AOOSP_IDENTIFY_IS_SAID(id) ) said= 1;
+  }
+  if( rgbi ) {
+    result= aoosp_send_setpwm(0x000, 0, 0, 0, 0);
+    if( result!=aoresult_ok ) return result;
+  }
+  if( said ) {
+    for( uint8_t chn=0; chn<3; chn++ ) {
+      result= aoosp_send_setpwmchn(0x000, chn, 0, 0, 0);
+      if( result!=aoresult_ok ) return result;
+    }
+  }
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Forces a topo build for the next app that is started with 
+            flag AOAPPS_MNGR_FLAGS_WITHTOPO.
+    @note   The app manager keeps the topo map when switching from one 
+            app with topo to another app with topo. It validates the map
+            with some telegrams (chain length and some node IDs), and only 
+            rebuilds it when validation fails. 
+    @note   An app that changes the chain configuration (e.g. the currents 
+            or the dithering of the nodes) shall call this function from 
+            its stop(), so that the next app gets a fresh chain.
+    @note   Starting an app without flag AOAPPS_MNGR_FLAGS_WITHTOPO (e.g. 
+            the voidapp) also invalidates the topo map.
+*/
+void aoapps_mngr_topo_invalidate() {
+  aoapps_mngr_topocache_valid= 0;
 }
 
 
@@ -450,6 +1314,7 @@ const char * aoapps_mngr_app_oled(int appix) {
 // State of the app (this manager runs topo build)
 typedef enum aoapps_mngr_state_e {
   AOAPPS_MNGR_STATE_TOPOBUILD,  // Topo build (resetinit, scan, config nodes)
+  AOAPPS_MNGR_STATE_APPSTART,   // Topo map is available, start app 
   AOAPPS_MNGR_STATE_APPANIM,    // Animation steps implemented by app 
   AOAPPS_MNGR_STATE_ERROR,      // Terminal state when an error is detected (that error is recorded in aoapps_runled_error)
 } aoapps_mngr_state_t;
@@ -459,10 +1324,35 @@ static aoapps_mngr_state_t aoapps_mngr_state;  // current state
 static aoresult_t          aoapps_mngr_error;  // last error reported by app
 
 
+// Returns 1 iff the current app has a topo map and runs its animation (so repair may use the topo map)
+static int aoapps_mngr_topoready() {
+  if( !(aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_WITHTOPO) ) return 0;
+  return aoapps_mngr_state==AOAPPS_MNGR_STATE_APPANIM;
+}
+
+
+// Returns 1 iff the current app was started and runs its animation without error (so it may be suspended)
+static int aoapps_mngr_animating() {
+  if( aoapps_mngr_result!=aoresult_ok ) return 0;
+  if( !(aoapps_mngr_apps[aoapps_mngr_appix]->flags & AOAPPS_MNGR_FLAGS_WITHTOPO) ) return 1;
+  return aoapps_mngr_state==AOAPPS_MNGR_STATE_APPANIM;
+}
+
+
 static aoresult_t aoapps_mngr_startwithtopo() {
   aoapps_mngr_error= aoresult_ok;
-  aoapps_mngr_state= AOAPPS_MNGR_STATE_TOPOBUILD;
-  aomw_topo_build_start();
+  if( aoapps_mngr_topocache_check() ) {
+    // Chain unchanged: skip topo build, but activate the nodes and switch off the LEDs like a build would
+    aoapps_mngr_error= aoapps_mngr_topocache_clear();
+    aoapps_mngr_state= aoapps_mngr_error==aoresult_ok ? AOAPPS_MNGR_STATE_APPSTART : AOAPPS_MNGR_STATE_ERROR;
+  } else {
+    aoapps_mngr_topocache_valid= 0;
+    aoapps_mngr_state= AOAPPS_MNGR_STATE_TOPOBUILD;
+    aomw_topo_build_start();
+    // Chain changed (or state unknown): suspended apps with topo can not resume
+    for( int appix=0; appix<aoapps_mngr_count; appix++ ) 
+      if( aoapps_mngr_apps[appix]->flags & AOAPPS_MNGR_FLAGS_WITHTOPO ) aoapps_mngr_suspended[appix]= 0;
+  }
   return aoapps_mngr_error;
 }
 
@@ -476,14 +1366,18 @@ static aoresult_t aoapps_mngr_stepwithtopo() {
         if( aoapps_mngr_error!=aoresult_ok ) aoapps_mngr_state= AOAPPS_MNGR_STATE_ERROR;
         return aoresult_ok; // loop topo build
       }
-      Serial.printf("%s: starting on %d RGBs\n", aoapps_mngr_apps[aoapps_mngr_appix].name, aomw_topo_numtriplets() );
-      aoapps_mngr_error= aoapps_mngr_apps[aoapps_mngr_appix].start(); // call start of app
-      if( aoapps_mngr_error!=aoresult_ok ) aoapps_mngr_state= AOAPPS_MNGR_STATE_ERROR;
-      aoapps_mngr_state= AOAPPS_MNGR_STATE_APPANIM;
+      aoapps_mngr_topocache_record();
+      aoapps_mngr_state= AOAPPS_MNGR_STATE_APPSTART;
+    break;
+
+    case AOAPPS_MNGR_STATE_APPSTART:
+      Serial.printf("%s: %s on %d RGBs\n", aoapps_mngr_apps[aoapps_mngr_appix]->name, aoapps_mngr_suspended[aoapps_mngr_appix]?"resuming":"starting", aomw_topo_numtriplets() );
+      aoapps_mngr_error= aoapps_mngr_stats_start(); // call start of app
+      aoapps_mngr_state= aoapps_mngr_error==aoresult_ok ? AOAPPS_MNGR_STATE_APPANIM : AOAPPS_MNGR_STATE_ERROR;
     break;
 
     case AOAPPS_MNGR_STATE_APPANIM:
-      aoapps_mngr_error= aoapps_mngr_apps[aoapps_mngr_appix].step();
+      aoapps_mngr_error= aoapps_mngr_stats_step();
       if( aoapps_mngr_error!=aoresult_ok ) aoapps_mngr_state= AOAPPS_MNGR_STATE_ERROR;
     break;
 
@@ -505,9 +1399,9 @@ static void aoapps_mngr_cmd_config( int argc, char * argv[] ) {
   if( argc==2 ) { 
     int count=0;
     for( int appix=0; appix<aoapps_mngr_app_count(); appix++ ) {
-      if( aoapps_mngr_apps[appix].help ) {
+      if( aoapps_mngr_apps[appix]->help ) {
         if( count==0 ) Serial.printf("Configurable apps\n");
-        Serial.printf("%s (%s)\n", aoapps_mngr_apps[appix].name, aoapps_mngr_apps[appix].oled );
+        Serial.printf("%s (%s)\n", aoapps_mngr_apps[appix]->name, aoapps_mngr_apps[appix]->oled );
         count++;
       }
     }
@@ -515,34 +1409,75 @@ static void aoapps_mngr_cmd_config( int argc, char * argv[] ) {
     return; 
   }
   
+  // Find the app
+  int appix= aoapps_mngr_app_find(argv[2]);
+  if( appix==AOAPPS_MNGR_FIND_NONE ) { Serial.printf("No registered app matches '%s'\n", argv[2]); return; }
+  if( appix==AOAPPS_MNGR_FIND_AMBIGUOUS ) { Serial.printf("ERROR: multiple apps start with '%s'\n", argv[2]); return; }
+  if( aoapps_mngr_apps[appix]->cmd==0 ) { Serial.printf("ERROR: app '%s' is not configurable\n",argv[2] ); return; }
+
   // List configuration help for specific app
   if( argc==3 ) {
-    int count=0; 
-    for( int appix=0; appix<aoapps_mngr_app_count(); appix++ ) {
-      if( aocmd_cint_isprefix(aoapps_mngr_app_name(appix),argv[2]) ) {
-        if( aoapps_mngr_apps[appix].cmd==0 ) { Serial.printf("ERROR: app '%s' is not configurable\n",argv[2] ); return; }
-        AORESULT_ASSERT( aoapps_mngr_apps[appix].help );
-        Serial.printf("%s", aoapps_mngr_apps[appix].help );
-        count++;
-      }
-    }
-    if( count==0 ) Serial.printf("No registered app matches '%s'\n", argv[2]);
+    AORESULT_ASSERT( aoapps_mngr_apps[appix]->help );
+    Serial.printf("%s", aoapps_mngr_apps[appix]->help );
     return;
   }
   
   // Call configuration handler for specific app
-  if( argc>3 ) {
-    int count=0; 
-    for( int appix=0; appix<aoapps_mngr_app_count(); appix++ ) {
-      if( aocmd_cint_isprefix(aoapps_mngr_app_name(appix),argv[2]) ) {
-        if( aoapps_mngr_apps[appix].cmd==0 ) { Serial.printf("ERROR: app '%s' is not configurable\n",argv[2] ); return; }
-        aoapps_mngr_apps[appix].cmd(argc,argv);
-        count++;
-      }
-    }
-    if( count==0 ) Serial.printf("No registered app matches '%s'\n", argv[2]);
+  // With an animation task, the app's state is owned by that task: post the command
+  if( aoapps_mngr_task_isother() ) aoapps_mngr_queue_post(AOAPPS_MNGR_QUEUE_OP_CONFIG, appix, argc, argv);
+  else aoapps_mngr_apps[appix]->cmd(argc,argv);
+}
+
+
+// Shows the statistics of one app (if it was stepped)
+static void aoapps_mngr_cmd_statsone(int appix) {
+  aoapps_mngr_stats_t * stats= &aoapps_mngr_stats[appix];
+  if( stats->steps==0 ) return;
+  uint32_t meanus= stats->sumus / stats->steps;
+  uint32_t workpm= (uint64_t)stats->frames * 1000 / stats->steps; // per mille
+  uint32_t fps10= stats->runms==0 ? 0 : (uint64_t)stats->frames * 10000 / stats->runms;
+  Serial.printf("%d %-10s %9lu %3lu.%lu%% %6lu %6lu %6lu %4lu.%lu %6lu\n", appix, aoapps_mngr_app_name(appix), 
+    (unsigned long)stats->steps, (unsigned long)workpm/10, (unsigned long)workpm%10, 
+    (unsigned long)stats->minus, (unsigned long)meanus, (unsigned long)stats->maxus, 
+    (unsigned long)fps10/10, (unsigned long)fps10%10, (unsigned long)stats->overs );
+  Serial.printf("  hist");
+  for( int bucket=0; bucket<AOAPPS_MNGR_STATS_BUCKETS; bucket++ ) Serial.printf(" %lu", (unsigned long)stats->hist[bucket] );
+  Serial.printf("\n");
+  uint32_t perframe10= stats->frames==0 ? 0 : (uint64_t)stats->tx * 10 / stats->frames;
+  Serial.printf("  osp tx %lu rx %lu, tx/frame %lu.%lu, tx/step max %lu\n", 
+    (unsigned long)stats->tx, (unsigned long)stats->rx, 
+    (unsigned long)perframe10/10, (unsigned long)perframe10%10, (unsigned long)stats->txmax );
+}
+
+
+// The handler for the "apps stats" command
+static void aoapps_mngr_cmd_stats( int argc, char * argv[] ) {
+  if( argc==2 ) {
+    Serial.printf("# %-10s %9s %6s %6s %6s %6s %6s %6s\n","name","steps","work","min","mean","max","fps","over");
+    for( int appix=0; appix<aoapps_mngr_app_count(); appix++ ) 
+      aoapps_mngr_cmd_statsone(appix);
+    Serial.printf("\nstep durations in us; hist buckets <%d, <%d, .., <%d, rest\n", 
+      AOAPPS_MNGR_STATS_US0, AOAPPS_MNGR_STATS_US0<<1, AOAPPS_MNGR_STATS_US0<<(AOAPPS_MNGR_STATS_BUCKETS-2) );
+    Serial.printf("over: number of steps exceeding the budget of %d us\n", AOAPPS_MNGR_BUDGET_US );
+    uint32_t apptx= 0, apprx= 0;
+    for( int appix=0; appix<aoapps_mngr_app_count(); appix++ ) { apptx+= aoapps_mngr_stats[appix].tx; apprx+= aoapps_mngr_stats[appix].rx; }
+    uint32_t alltx= aoapps_mngr_stats_delta(aoapps_mngr_stats_tx0, aospi_txcount_get());
+    uint32_t allrx= aoapps_mngr_stats_delta(aoapps_mngr_stats_rx0, aospi_rxcount_get());
+    Serial.printf("osp: apps tx %lu rx %lu; manager and commands tx %lu rx %lu\n", 
+      (unsigned long)apptx, (unsigned long)apprx, 
+      (unsigned long)(alltx>apptx?alltx-apptx:0), (unsigned long)(allrx>apprx?allrx-apprx:0) );
+    Serial.printf("repair: interval %lu ms, %lu nodes repaired, %lu broadcasts\n", 
+      (unsigned long)aoapps_mngr_repair_intervalms(), (unsigned long)aoapps_mngr_repair_nodes, (unsigned long)aoapps_mngr_repair_broadcasts );
+    Serial.printf("idle: %lu of %lu steps came before there was work (could have slept)\n", 
+      (unsigned long)aoapps_mngr_idle_early, (unsigned long)aoapps_mngr_idle_steps );
+    return;
+  } 
+  if( argc==3 && aocmd_cint_isprefix("reset",argv[2]) ) {
+    aoapps_mngr_stats_reset();
+    if( argv[0][0]!='@' ) Serial.printf( aoapps_mngr_task_isother() ? "stats reset posted\n" : "stats reset\n" );
     return;
   }
+  Serial.printf("ERROR: 'apps stats' has unknown arguments\n" ); 
 }
 
 
@@ -552,13 +1487,13 @@ static void aoapps_mngr_cmd_listone(int appix) {
   int cur= aoapps_mngr_app_appix();
   int run= aoapps_mngr_app_running();
   const char * mode;
-  if( appix!=cur ) mode= "stop";
+  if( appix!=cur ) mode= aoapps_mngr_suspended[appix] ? "susp" : "stop";
   else if( run ) mode= "run"; 
   else mode= "idle";
   char flags[4]="tre";
-  if( aoapps_mngr_apps[appix].flags & AOAPPS_MNGR_FLAGS_WITHTOPO   ) flags[0]='T';
-  if( aoapps_mngr_apps[appix].flags & AOAPPS_MNGR_FLAGS_WITHREPAIR ) flags[1]='R';
-  if( aoapps_mngr_apps[appix].flags & AOAPPS_MNGR_FLAGS_NEXTONERR  ) flags[2]='E';
+  if( aoapps_mngr_apps[appix]->flags & AOAPPS_MNGR_FLAGS_WITHTOPO   ) flags[0]='T';
+  if( aoapps_mngr_apps[appix]->flags & AOAPPS_MNGR_FLAGS_WITHREPAIR ) flags[1]='R';
+  if( aoapps_mngr_apps[appix]->flags & AOAPPS_MNGR_FLAGS_NEXTONERR  ) flags[2]='E';
   const char* oled= aoapps_mngr_app_oled(appix);
   Serial.printf("%d %-10s %-4s %-5s %s\n",appix,name,mode,flags,oled);
 }
@@ -573,6 +1508,17 @@ static void aoapps_mngr_cmd_listall(int verbose) {
 }
 
 
+// Feedback for "apps switch": lists the app, or (with an animation task) that the switch was posted
+static void aoapps_mngr_cmd_switched(int appix) {
+  if( aoapps_mngr_task_isother() ) Serial.printf("switch to %d %s posted\n", appix, aoapps_mngr_app_name(appix) );
+  else aoapps_mngr_cmd_listone(appix);
+}
+
+
+// Forward declaration; "apps bin" hands the serial port to the binary command channel
+static void aoapps_mngr_bin_enter();
+
+
 // The handler for the "apps" command
 static void aoapps_mngr_cmd( int argc, char * argv[] ) {
   if( argc==1 ) {
@@ -590,22 +1536,24 @@ static void aoapps_mngr_cmd( int argc, char * argv[] ) {
     if( ok ) {
       if( appix<0 || appix>=aoapps_mngr_app_count() ) { Serial.printf("ERROR: %d out of bounds\n",appix ); return; }
       aoapps_mngr_switch(appix);
-      if( argv[0][0]!='@' ) aoapps_mngr_cmd_listone(appix);
+      if( argv[0][0]!='@' ) aoapps_mngr_cmd_switched(appix);
       return;
     }
     // <app> is string?
-    appix= -1;
-    for( int ix=0; ix<aoapps_mngr_app_count(); ix++ ) {
-      if( aocmd_cint_isprefix(aoapps_mngr_app_name(ix),argv[2]) ) {
-        appix= ix; break; 
-      }
-    }
-    if( appix==-1 ) { Serial.printf("ERROR: no app with name starting with '%s'\n",argv[2] ); return; }
+    appix= aoapps_mngr_app_find(argv[2]);
+    if( appix==AOAPPS_MNGR_FIND_NONE ) { Serial.printf("ERROR: no app with name starting with '%s'\n",argv[2] ); return; }
+    if( appix==AOAPPS_MNGR_FIND_AMBIGUOUS ) { Serial.printf("ERROR: multiple apps start with '%s'\n",argv[2] ); return; }
     aoapps_mngr_switch(appix);
-    if( argv[0][0]!='@' ) aoapps_mngr_cmd_listone(appix);
+    if( argv[0][0]!='@' ) aoapps_mngr_cmd_switched(appix);
     return;
   } else if( aocmd_cint_isprefix("config",argv[1]) ) {
     aoapps_mngr_cmd_config(argc,argv);
+  } else if( aocmd_cint_isprefix("stats",argv[1]) ) {
+    aoapps_mngr_cmd_stats(argc,argv);
+  } else if( aocmd_cint_isprefix("bin",argv[1]) ) {
+    if( argc!=2 ) { Serial.printf("ERROR: too many args\n" ); return; }
+    if( argv[0][0]!='@' ) Serial.printf("apps: binary mode, until op 0x%02X or line '%s'\n", AOAPPS_MNGR_BIN_OP_TEXT, AOAPPS_MNGR_BIN_TEXTLINE );
+    aoapps_mngr_bin_enter();
   } else {
     Serial.printf("ERROR: unknown arguments for 'apps'\n" ); return;
   }
@@ -625,6 +1573,12 @@ static const char aoapps_mngr_cmd_longhelp[] =
   "- without arguments, shows which apps offer configuration\n"
   "- with app name shows help for configuration of that app\n"
   "- with app name and arguments configures that app (see its help)\n"
+  "SYNTAX: apps stats [reset]\n"
+  "- without argument, shows step() duration and FPS statistics per app\n"
+  "- with argument clears the statistics\n"
+  "SYNTAX: apps bin\n"
+  "- hands the serial port to binary command frames (for a host, see readme)\n"
+  "- binary op 0x06, or the line 'apps text', returns to text commands\n"
   "NOTES:\n"
   "- supports @-prefix to suppress output\n"
 ;
@@ -638,3 +1592,272 @@ int aoapps_mngr_cmd_register() {
   return aocmd_cint_register(aoapps_mngr_cmd, "apps", "manage and configure active app", aoapps_mngr_cmd_longhelp);
 }
 
+
+
+// === binary command channel ================================================
+// Next to the text "apps" command, a host (test rig, PC tool) may drive the 
+// app manager with binary frames over the same serial port. The text command
+// "apps bin" switches the port to binary mode: from then on 
+// aoapps_mngr_bin_pollserial() takes all received bytes (the command 
+// interpreter gets none), until the host sends AOAPPS_MNGR_BIN_OP_TEXT. 
+// Should the host die in binary mode, a human can still type the line 
+// AOAPPS_MNGR_BIN_TEXTLINE ("apps text") to get back to text commands.
+// A request frame is SYNC LEN SEQ OPS[LEN] CRC; OPS is a batch of one or more
+// operations (AOAPPS_MNGR_BIN_OP_XXX, each followed by its arguments). CRC is 
+// a CRC-8 (polynomial 0x07) over LEN, SEQ and OPS. The response frame has the 
+// same layout; SEQ is copied from the request and OPS is replaced by one 
+// status byte (AOAPPS_MNGR_BIN_STATUS_XXX) per executed operation, optionally 
+// followed by result bytes. Multi-byte values are little endian.
+// Apps (and their config handlers) may still print text. A response is 
+// written with one Serial.write(), and AOAPPS_MNGR_BIN_SYNC never occurs in
+// (ASCII) text, so a host skips bytes until SYNC, and checks LEN and CRC.
+
+
+// When a frame is not complete within this time (in ms), its bytes are dropped (resync on next SYNC)
+#define AOAPPS_MNGR_BIN_TIMEOUTMS 100
+
+
+// Frame overhead: SYNC, LEN, SEQ, CRC
+#define AOAPPS_MNGR_BIN_OVERHEAD 4
+
+
+static int      aoapps_mngr_bin_mode;                              // serial port carries binary frames (1) or text commands (0)
+static uint8_t  aoapps_mngr_bin_req[AOAPPS_MNGR_BIN_OVERHEAD+255]; // request frame being received
+static int      aoapps_mngr_bin_reqlen;                            // number of bytes in aoapps_mngr_bin_req
+static uint32_t aoapps_mngr_bin_reqms;                             // time stamp of last received byte
+static uint8_t  aoapps_mngr_bin_rsp[AOAPPS_MNGR_BIN_OVERHEAD+255]; // response frame being composed
+static int      aoapps_mngr_bin_rsplen;                            // number of bytes in aoapps_mngr_bin_rsp
+static char     aoapps_mngr_bin_line[sizeof AOAPPS_MNGR_BIN_TEXTLINE]; // text received outside frames (to detect AOAPPS_MNGR_BIN_TEXTLINE)
+static int      aoapps_mngr_bin_linelen;                           // number of bytes in aoapps_mngr_bin_line (more when it overflowed)
+
+
+// Switches the serial port to binary mode ("apps bin"); a partial frame from before is dropped
+static void aoapps_mngr_bin_enter() {
+  aoapps_mngr_bin_mode= 1;
+  aoapps_mngr_bin_reqlen= 0;
+  aoapps_mngr_bin_linelen= 0;
+}
+
+
+// Collects a byte received outside a frame; a line AOAPPS_MNGR_BIN_TEXTLINE switches back to text mode
+static void aoapps_mngr_bin_text(int byte) {
+  if( byte=='\n' || byte=='\r' ) {
+    int match= aoapps_mngr_bin_linelen==sizeof AOAPPS_MNGR_BIN_TEXTLINE-1 
+            && memcmp(aoapps_mngr_bin_line, AOAPPS_MNGR_BIN_TEXTLINE, aoapps_mngr_bin_linelen)==0;
+    aoapps_mngr_bin_linelen= 0;
+    if( match ) {
+      aoapps_mngr_bin_mode= 0;
+      Serial.printf("apps: text mode\n");
+    }
+    return;
+  }
+  if( aoapps_mngr_bin_linelen<(int)sizeof aoapps_mngr_bin_line ) aoapps_mngr_bin_line[aoapps_mngr_bin_linelen]= byte;
+  if( aoapps_mngr_bin_linelen<=(int)sizeof aoapps_mngr_bin_line ) aoapps_mngr_bin_linelen++; // stops one past the buffer: no match
+}
+
+
+// Returns the CRC-8 (polynomial 0x07, init 0x00) of the `size` bytes at `buf`
+static uint8_t aoapps_mngr_bin_crc(const uint8_t * buf, int size) {
+  uint8_t crc= 0x00;
+  for( int i=0; i<size; i++ ) {
+    crc^= buf[i];
+    for( int bit=0; bit<8; bit++ ) crc= crc & 0x80 ? (crc<<1)^0x07 : crc<<1;
+  }
+  return crc;
+}
+
+
+// Appends one byte to the response payload (aoapps_mngr_bin_rspsize() checked that it fits)
+static void aoapps_mngr_bin_put(uint8_t byte) {
+  AORESULT_ASSERT( aoapps_mngr_bin_rsplen < AOAPPS_MNGR_BIN_OVERHEAD-1+255 );
+  aoapps_mngr_bin_rsp[aoapps_mngr_bin_rsplen++]= byte;
+}
+
+
+// Posts an operation for the animation task; returns the status (BUSY when the queue is full, without printing)
+static int aoapps_mngr_bin_post(int op, int appix, int argc, char * argv[]) {
+  if( aoapps_mngr_queue_isfull() ) return AOAPPS_MNGR_BIN_STATUS_BUSY;
+  return aoapps_mngr_queue_post(op, appix, argc, argv) ? AOAPPS_MNGR_BIN_STATUS_OK : AOAPPS_MNGR_BIN_STATUS_ARG;
+}
+
+
+// Posts (from another task) or executes a switch; returns the status
+static int aoapps_mngr_bin_switch(int appix) {
+  if( appix<0 || appix>=aoapps_mngr_app_count() ) return AOAPPS_MNGR_BIN_STATUS_ARG;
+  if( aoapps_mngr_task_isother() ) return aoapps_mngr_bin_post(AOAPPS_MNGR_QUEUE_OP_SWITCH, appix, 0, 0);
+  aoapps_mngr_switch(appix);
+  return AOAPPS_MNGR_BIN_STATUS_OK;
+}
+
+
+// Posts (from another task) or executes a switchnext; returns the status
+static int aoapps_mngr_bin_switchnext() {
+  if( aoapps_mngr_task_isother() ) return aoapps_mngr_bin_post(AOAPPS_MNGR_QUEUE_OP_SWITCHNEXT, 0, 0, 0);
+  aoapps_mngr_switchnext();
+  return AOAPPS_MNGR_BIN_STATUS_OK;
+}
+
+
+// Posts (from another task) or executes a stats reset; returns the status
+static int aoapps_mngr_bin_statsreset() {
+  if( aoapps_mngr_task_isother() ) return aoapps_mngr_bin_post(AOAPPS_MNGR_QUEUE_OP_STATSRESET, 0, 0, 0);
+  aoapps_mngr_stats_reset();
+  return AOAPPS_MNGR_BIN_STATUS_OK;
+}
+
+
+// Splits the `size` bytes of text at `text` in arguments, and passes them to the config handler of app `appix`; returns the status
+static int aoapps_mngr_bin_config(int appix, const uint8_t * text, int size) {
+  if( appix<0 || appix>=aoapps_mngr_app_count() || aoapps_mngr_apps[appix]->cmd==0 ) return AOAPPS_MNGR_BIN_STATUS_ARG;
+  // Same argv as for "@apps config <app> <args>" (the @ suppresses the handler's feedback)
+  char buf[256];
+  memcpy(buf, text, size);
+  buf[size]= '\0';
+  char * argv[AOAPPS_MNGR_QUEUE_MAXARGS];
+  int argc= 0;
+  argv[argc++]= (char*)"@apps";
+  argv[argc++]= (char*)"config";
+  argv[argc++]= (char*)aoapps_mngr_app_name(appix);
+  char * arg= strtok(buf," ");
+  while( arg ) {
+    if( argc==AOAPPS_MNGR_QUEUE_MAXARGS ) return AOAPPS_MNGR_BIN_STATUS_ARG;
+    argv[argc++]= arg;
+    arg= strtok(0," ");
+  }
+  if( argc==3 ) return AOAPPS_MNGR_BIN_STATUS_ARG; // no arguments: that would be a help request
+  // The arguments must fit a queue entry (also when there is no animation task, so a host sees the same limits)
+  int bytes= 0;
+  for( int i=0; i<argc; i++ ) bytes+= strlen(argv[i])+1;
+  if( bytes>AOAPPS_MNGR_QUEUE_BUFSIZE ) return AOAPPS_MNGR_BIN_STATUS_ARG;
+  if( aoapps_mngr_task_isother() ) return aoapps_mngr_bin_post(AOAPPS_MNGR_QUEUE_OP_CONFIG, appix, argc, argv);
+  aoapps_mngr_apps[appix]->cmd(argc,argv);
+  return AOAPPS_MNGR_BIN_STATUS_OK;
+}
+
+
+// Returns the number of response payload bytes that executing the `size` bytes of operations at `ops` produces
+static int aoapps_mngr_bin_rspsize(const uint8_t * ops, int size) {
+  int pos= 0;
+  int bytes= 0;
+  while( pos<size ) {
+    int op= ops[pos++];
+    int left= size-pos;
+    bytes+= 1; // status
+    if( op==AOAPPS_MNGR_BIN_OP_SWITCH ) {
+      if( left<2 ) return bytes;
+      pos+= 2;
+    } else if( op==AOAPPS_MNGR_BIN_OP_CONFIG ) {
+      if( left<3 || left<3+ops[pos+2] ) return bytes;
+      pos+= 3+ops[pos+2];
+    } else if( op==AOAPPS_MNGR_BIN_OP_STATE ) {
+      bytes+= 4; // appix, running, aoresult
+    } else if( op!=AOAPPS_MNGR_BIN_OP_SWITCHNEXT && op!=AOAPPS_MNGR_BIN_OP_STATSRESET && op!=AOAPPS_MNGR_BIN_OP_TEXT ) {
+      return bytes; // unknown op ends the batch
+    }
+  }
+  return bytes;
+}
+
+
+// Executes the operations of the (complete, CRC checked) request, and composes the response payload
+static void aoapps_mngr_bin_exec(const uint8_t * ops, int size) {
+  int pos= 0;
+  while( pos<size ) {
+    int op= ops[pos++];
+    int left= size-pos;
+    int status;
+    if( op==AOAPPS_MNGR_BIN_OP_SWITCH ) {
+      if( left<2 ) { aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_ARG); return; }
+      status= aoapps_mngr_bin_switch( ops[pos] | ops[pos+1]<<8 );
+      pos+= 2;
+      aoapps_mngr_bin_put(status);
+    } else if( op==AOAPPS_MNGR_BIN_OP_SWITCHNEXT ) {
+      aoapps_mngr_bin_put( aoapps_mngr_bin_switchnext() );
+    } else if( op==AOAPPS_MNGR_BIN_OP_CONFIG ) {
+      if( left<3 || left<3+ops[pos+2] ) { aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_ARG); return; }
+      status= aoapps_mngr_bin_config( ops[pos] | ops[pos+1]<<8, &ops[pos+3], ops[pos+2] );
+      pos+= 3+ops[pos+2];
+      aoapps_mngr_bin_put(status);
+    } else if( op==AOAPPS_MNGR_BIN_OP_STATSRESET ) {
+      aoapps_mngr_bin_put( aoapps_mngr_bin_statsreset() );
+    } else if( op==AOAPPS_MNGR_BIN_OP_STATE ) {
+      int appix= aoapps_mngr_app_appix();
+      aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_OK);
+      aoapps_mngr_bin_put(appix & 0xFF);
+      aoapps_mngr_bin_put(appix >> 8);
+      aoapps_mngr_bin_put(aoapps_mngr_app_running());
+      aoapps_mngr_bin_put(aoapps_mngr_result);
+    } else if( op==AOAPPS_MNGR_BIN_OP_TEXT ) {
+      // Takes effect after this frame (its response is still binary)
+      aoapps_mngr_bin_mode= 0;
+      aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_OK);
+    } else {
+      // Unknown op: its arguments (so the rest of the batch) can not be parsed
+      aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_OP); 
+      return;
+    }
+  }
+}
+
+
+// Handles the complete request frame in aoapps_mngr_bin_req, and sends the response
+static void aoapps_mngr_bin_handle() {
+  int len= aoapps_mngr_bin_req[1];
+  aoapps_mngr_bin_rsp[0]= AOAPPS_MNGR_BIN_SYNC;
+  aoapps_mngr_bin_rsp[2]= aoapps_mngr_bin_req[2]; // SEQ
+  aoapps_mngr_bin_rsplen= 3;
+  uint8_t crc= aoapps_mngr_bin_crc(&aoapps_mngr_bin_req[1], 2+len);
+  if( crc!=aoapps_mngr_bin_req[3+len] ) aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_CRC);
+  else if( aoapps_mngr_bin_rspsize(&aoapps_mngr_bin_req[3], len)>255 ) aoapps_mngr_bin_put(AOAPPS_MNGR_BIN_STATUS_SIZE);
+  else aoapps_mngr_bin_exec(&aoapps_mngr_bin_req[3], len);
+  aoapps_mngr_bin_rsp[1]= aoapps_mngr_bin_rsplen-3;
+  aoapps_mngr_bin_rsp[aoapps_mngr_bin_rsplen]= aoapps_mngr_bin_crc(&aoapps_mngr_bin_rsp[1], aoapps_mngr_bin_rsplen-1);
+  aoapps_mngr_bin_rsplen++;
+  Serial.write(aoapps_mngr_bin_rsp, aoapps_mngr_bin_rsplen);
+}
+
+
+/*!
+    @brief  Receives and executes binary command frames from Serial.
+    @note   Call this from loop(), before aocmd_cint_pollserial(). 
+            It does nothing until the text command "apps bin" switched
+            the serial port to binary mode. In binary mode it takes all
+            bytes from Serial (so aocmd_cint_pollserial() gets none): 
+            bytes outside a frame (not starting with AOAPPS_MNGR_BIN_SYNC) 
+            are dropped; when a frame is complete it is executed and a 
+            response frame is sent. AOAPPS_MNGR_BIN_OP_TEXT switches back,
+            and so does the text line "apps text" (outside frames), in 
+            case the host is gone.
+    @note   A frame is SYNC LEN SEQ OPS[LEN] CRC, the response echoes SEQ
+            and has one status byte per operation. See aoapps_mngr.h for 
+            the operations and the status codes.
+    @note   A request with a CRC error is not executed; its response only
+            holds AOAPPS_MNGR_BIN_STATUS_CRC. A request whose response 
+            would exceed 255 bytes is not executed either; its response 
+            only holds AOAPPS_MNGR_BIN_STATUS_SIZE. An incomplete frame is 
+            dropped after AOAPPS_MNGR_BIN_TIMEOUTMS.
+    @note   Operations are executed in order, like the equivalent text 
+            commands, and with the same effect (e.g. with an animation 
+            task switch, config and stats reset are posted). Apps and 
+            their config handlers may still print text (between frames).
+    @note   The host should wait for the feedback of "apps bin" before it
+            sends the first frame; bytes sent along with the command are 
+            taken by the command interpreter.
+*/
+void aoapps_mngr_bin_pollserial() {
+  if( !aoapps_mngr_bin_mode ) return;
+  if( aoapps_mngr_bin_reqlen>0 && millis()-aoapps_mngr_bin_reqms > AOAPPS_MNGR_BIN_TIMEOUTMS ) aoapps_mngr_bin_reqlen= 0;
+  // Stop after a frame that switched back to text mode: the next bytes are for the command interpreter
+  while( aoapps_mngr_bin_mode && Serial.available()>0 ) {
+    int byte= Serial.read();
+    // Not in a frame, and no SYNC: drop the byte (resync), but look for the text line that switches back
+    if( aoapps_mngr_bin_reqlen==0 && byte!=AOAPPS_MNGR_BIN_SYNC ) { aoapps_mngr_bin_text(byte); continue; }
+    aoapps_mngr_bin_linelen= 0;
+    aoapps_mngr_bin_req[aoapps_mngr_bin_reqlen++]= byte;
+    aoapps_mngr_bin_reqms= millis();
+    if( aoapps_mngr_bin_reqlen>=2 && aoapps_mngr_bin_reqlen==aoapps_mngr_bin_req[1]+AOAPPS_MNGR_BIN_OVERHEAD ) {
+      aoapps_mngr_bin_handle();
+      aoapps_mngr_bin_reqlen= 0;
+    }
+  }
+}
@@ -25,14 +25,24 @@
 #include <aoresult.h>     // aoresult_t
 
 
-// Total number of registration slots for apps.
+// Initial number of registration slots for apps; the registry grows when more apps register (may be overridden with a build flag).
+#ifndef AOAPPS_MNGR_REGISTRATION_SLOTS
 #define AOAPPS_MNGR_REGISTRATION_SLOTS 8
+#endif
 
 
 // The handler signatures for an app
 typedef aoresult_t (*aoapps_mngr_start_t)(void); // Function starting the (state machine of) the app.
 typedef aoresult_t (*aoapps_mngr_step_t )(void); // Function progressing the (state machine of) the app.
 typedef void       (*aoapps_mngr_stop_t )(void); // Function stopping the app (shuts down hardware that is no longer needed, may result in errors, but is ignored anyhow).
+typedef void       (*aoapps_mngr_suspend_t)(void); // Optional: like stop, but the app keeps its state so that it can resume.
+typedef aoresult_t (*aoapps_mngr_resume_t )(void); // Optional: like start, but continues from the state kept by suspend (repaints the LEDs).
+typedef aoresult_t (*aoapps_mngr_button_t )(int but, int event); // Optional: handles an event (AOAPPS_MNGR_BUTTON_XXX) of the X or Y button (AOUI32_BUT_X or AOUI32_BUT_Y).
+
+// Button events delivered by the manager to an app's on_button handler
+#define AOAPPS_MNGR_BUTTON_PRESS   1 // the button went down
+#define AOAPPS_MNGR_BUTTON_REPEAT  2 // the button is still down (every AOAPPS_MNGR_BUTTON_REPEATMS after the press)
+#define AOAPPS_MNGR_BUTTON_RELEASE 3 // the button went up
 
 // An app may implement a command handler plugin for configuration. It is much like C's main, it has argc and argv.
 typedef void       (*aoapps_mngr_cmd_t)( int argc, char * argv[] );
@@ -44,8 +54,67 @@ typedef void       (*aoapps_mngr_cmd_t)( int argc, char * argv[] );
 #define AOAPPS_MNGR_FLAGS_NEXTONERR   0x04
 #define AOAPPS_MNGR_FLAGS_ALL         (AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR | AOAPPS_MNGR_FLAGS_NEXTONERR ) 
 
-// To register an app pass its (identifier and oled) name, help text for the two buttons, feature flags, pointers to its three handlers, command handler and command help. Asserts when no more free slots.
-void aoapps_mngr_register(const char * name, const char * oled, const char * xlbl, const char * ylbl, int flags, aoapps_mngr_start_t start, aoapps_mngr_step_t step, aoapps_mngr_stop_t stop, aoapps_mngr_cmd_t cmd, const char * help);  
+// The descriptor of an app; see aoapps_mngr_register() for the meaning of the fields
+typedef struct aoapps_mngr_app_s {
+  const char *          name;    // the (short) name of the app (identifier)
+  const char *          oled;    // the (long) name of the app for on the OLED (spaces and caps allowed)
+  const char *          xlbl;    // the label (function) for the x-button
+  const char *          ylbl;    // the label (function) for the y-button
+  int                   flags;   // indicate if topo and or repair should be run by mngr
+  aoapps_mngr_start_t   start;   // reset app state machine to the starting state
+  aoapps_mngr_step_t    step;    // step the app state machine
+  aoapps_mngr_stop_t    stop;    // shutdown the app state machine (eg signaling LEDs)
+  aoapps_mngr_cmd_t     cmd;     // plugin for 'apps config' if an app has configuration needs
+  const char *          help;    // help text for configuration
+  aoapps_mngr_suspend_t suspend; // optional: stop, but keep state for resume
+  aoapps_mngr_resume_t  resume;  // optional: start from the state kept by suspend
+  aoapps_mngr_button_t  on_button; // optional: handles X/Y button events (instead of polling aoui32 in step)
+} aoapps_mngr_app_t;
+
+// Returns true iff all characters of name are alphanumeric; usable at compile time (recursive, so also C++11)
+constexpr bool aoapps_mngr_name_alnum(const char * name) {
+  return *name==0 || ( ( ('0'<=*name && *name<='9') || ('a'<=*name && *name<='z') || ('A'<=*name && *name<='Z') ) && aoapps_mngr_name_alnum(name+1) );
+}
+// Returns true iff name is a legal app name (non-empty, alphanumeric); usable at compile time
+constexpr bool aoapps_mngr_name_ok(const char * name) {
+  return name!=nullptr && *name!=0 && aoapps_mngr_name_alnum(name);
+}
+// Returns true iff app is a legal descriptor (see aoapps_mngr_register()); usable at compile time
+constexpr bool aoapps_mngr_app_ok(const aoapps_mngr_app_t & app) {
+  return aoapps_mngr_name_ok(app.name) 
+    && app.oled!=nullptr && app.xlbl!=nullptr && app.ylbl!=nullptr 
+    && app.start!=nullptr && app.step!=nullptr && app.stop!=nullptr 
+    && (app.cmd==nullptr) == (app.help==nullptr) 
+    && (app.suspend==nullptr) == (app.resume==nullptr) 
+    && 0==(app.flags & ~AOAPPS_MNGR_FLAGS_ALL);
+}
+// Returns true iff all descriptors in the table (from index ix onwards) are legal; usable at compile time (recursive, so also C++11)
+template<int N> constexpr bool aoapps_mngr_table_ok(const aoapps_mngr_app_t (&table)[N], int ix=0) {
+  return ix>=N || ( aoapps_mngr_app_ok(table[ix]) && aoapps_mngr_table_ok(table,ix+1) );
+}
+
+// Declares a table of app descriptors; constexpr, so it is checked at compile time and stored in flash
+#define AOAPPS_MNGR_TABLE(table, ...) \
+  static constexpr aoapps_mngr_app_t table[] = { __VA_ARGS__ }; \
+  static_assert( aoapps_mngr_table_ok(table), "app table '" #table "' has an illegal descriptor (see aoapps_mngr_register)" )
+
+// To register an app pass its (identifier and oled) name, help text for the two buttons, feature flags, pointers to its three handlers, command handler and command help, and optionally suspend/resume and button handlers. Asserts when no more free slots.
+void aoapps_mngr_register(const char * name, const char * oled, const char * xlbl, const char * ylbl, int flags, aoapps_mngr_start_t start, aoapps_mngr_step_t step, aoapps_mngr_stop_t stop, aoapps_mngr_cmd_t cmd, const char * help, aoapps_mngr_suspend_t suspend=0, aoapps_mngr_resume_t resume=0, aoapps_mngr_button_t on_button=0);  
+// To register an app pass its descriptor; it is not copied, so it must be static (preferably constexpr, see AOAPPS_MNGR_TABLE). Asserts when no more free slots.
+void aoapps_mngr_register_app(const aoapps_mngr_app_t * app);
+// Registers the `count` apps in `table`; the descriptors are not checked at run time, so declare the table with AOAPPS_MNGR_TABLE (checked at compile time). Asserts when a name is already registered.
+void aoapps_mngr_register_table(const aoapps_mngr_app_t * table, int count);
+// Registers all apps in a table declared with AOAPPS_MNGR_TABLE; the number of apps is inferred from the table
+template<int N> void aoapps_mngr_register_table(const aoapps_mngr_app_t (&table)[N]) {
+  aoapps_mngr_register_table(table, N);
+}
+#if __cplusplus >= 201703L
+// Registers all apps in a table, passed as template argument so that it is (also) checked at compile time here (needs C++17)
+template<const auto & table> void aoapps_mngr_register_table() {
+  static_assert( aoapps_mngr_table_ok(table), "app table has an illegal descriptor (see aoapps_mngr_register)" );
+  aoapps_mngr_register_table(table);
+}
+#endif
 // Initializes the apps manager (selects app 0, but does not run it)
 void aoapps_mngr_init();
 
@@ -62,6 +131,22 @@ void aoapps_mngr_stop();
 void aoapps_mngr_switch(int appix);
 // Switches the current app (must be running) to the next app
 void aoapps_mngr_switchnext();
+// Forces a topo build for the next app with topo (instead of validating the kept topo map)
+void aoapps_mngr_topo_invalidate();
+// Steps the apps from a dedicated task pinned to core (loop() must then no longer step); switch, config and stats reset are queued
+void aoapps_mngr_task_start(int core=0);
+
+
+// Returns the time (in us) left in the budget of the current step (0 when exhausted)
+uint32_t aoapps_mngr_budget_left();
+// Apps call this from step() to pass the time (millis() time stamp) they next have work
+void aoapps_mngr_wakeup_at(uint32_t ms);
+// Returns the time (in ms) the sketch may sleep before the next aoapps_mngr_step() (0 when there is work)
+uint32_t aoapps_mngr_idle_ms();
+// Apps call this from step() when that step did work (e.g. painted a frame); used for statistics
+void aoapps_mngr_stats_frame();
+// Clears the step statistics of all apps (posted to the animation task, when called from another task)
+void aoapps_mngr_stats_reset();
 
 
 // Returns index of current app
@@ -74,10 +159,33 @@ int aoapps_mngr_app_count();
 const char * aoapps_mngr_app_name(int appix);
 // Gets the long name (for oled) of the app at appix; 0 <= appix < aoapps_mngr_app_count()
 const char * aoapps_mngr_app_oled(int appix);
+// Returns the appix of the app with name (or name prefix) `name`, or one of AOAPPS_MNGR_FIND_XXX
+#define AOAPPS_MNGR_FIND_NONE      (-1) // no app matches
+#define AOAPPS_MNGR_FIND_AMBIGUOUS (-2) // multiple apps start with the name
+int aoapps_mngr_app_find(const char * name);
 
 
 // Registers the "app" command with the command interpreter.
 int aoapps_mngr_cmd_register();
 
 
+// Binary command channel: request SYNC LEN SEQ OPS[LEN] CRC8, response SYNC LEN SEQ STATUS.. CRC8 (see aoapps_mngr.cpp)
+#define AOAPPS_MNGR_BIN_SYNC           0xA5 // first byte of a frame (never in ASCII text)
+#define AOAPPS_MNGR_BIN_OP_SWITCH      0x01 // args: appix (2 bytes)
+#define AOAPPS_MNGR_BIN_OP_SWITCHNEXT  0x02 // no args
+#define AOAPPS_MNGR_BIN_OP_CONFIG      0x03 // args: appix (2 bytes), size (1 byte), text (size bytes, as in "apps config <app> <text>")
+#define AOAPPS_MNGR_BIN_OP_STATSRESET  0x04 // no args
+#define AOAPPS_MNGR_BIN_OP_STATE       0x05 // no args; result after status: appix (2 bytes), running (1 byte), aoresult_t (1 byte)
+#define AOAPPS_MNGR_BIN_OP_TEXT        0x06 // no args; after this frame, the serial port carries text commands again
+#define AOAPPS_MNGR_BIN_STATUS_OK      0x00 // operation executed (or posted to the animation task)
+#define AOAPPS_MNGR_BIN_STATUS_ARG     0x01 // argument missing, out of range or too long; rest of batch skipped when truncated
+#define AOAPPS_MNGR_BIN_STATUS_BUSY    0x02 // animation task queue full; operation dropped
+#define AOAPPS_MNGR_BIN_STATUS_OP      0x03 // unknown operation; rest of batch skipped
+#define AOAPPS_MNGR_BIN_STATUS_CRC     0x80 // frame CRC error; nothing executed
+#define AOAPPS_MNGR_BIN_STATUS_SIZE    0x81 // response would exceed 255 bytes; nothing executed
+#define AOAPPS_MNGR_BIN_TEXTLINE       "apps text" // a text line (outside frames) that also switches back to text commands (when the host is gone)
+// Receives and executes binary command frames from Serial, once "apps bin" switched to binary mode; call in loop() before aocmd_cint_pollserial()
+void aoapps_mngr_bin_pollserial();
+
+
 #endif
@@ -21,8 +21,9 @@
 #include <Arduino.h>       // Serial.printf
 #include <aoresult.h>      // AORESULT_ASSERT, aoresult_t
 #include <aomw.h>          // aomw_topo_settriplet()
-#include <aoui32.h>        // aoui32_but_wentdown()
+#include <aoui32.h>        // AOUI32_BUT_X
 #include <aoapps_mngr.h>   // aoapps_mngr_register
+#include <aoapps_frame.h>  // aoapps_frame_set()
 #include <aoapps_runled.h> // own
 
 
@@ -33,6 +34,7 @@ DESCRIPTION
 - There is a "virtual cursor" that runs from the begin of the chain to the end and then back
 - Chain length and node types are auto detected
 - Every 25ms the cursor advances one LED and paints that in the current color
+- When a step comes late, the cursor advances as many LEDs as are due (so speed is independent of load)
 - Every time the cursor hits the begin or end of the chain, it steps color
 - Color palette: red, yellow, green, cyan, magenta
 
@@ -66,19 +68,14 @@ static const aomw_topo_rgb_t * const aoapps_runled_anim_rgbs[] = {
 static int      aoapps_runled_anim_tix;
 static int      aoapps_runled_anim_colorix;
 static int      aoapps_runled_anim_dir;
+static int      aoapps_runled_anim_bounced; // cursor has hit an end at least once (before that, the LEDs ahead are off)
 static uint32_t aoapps_runled_anim_ms;
 
 
-// Step of the runled state machine
-static aoresult_t aoapps_runled_anim() {
-  aoresult_t result;
-  
-  // Is it time for an animation step
-  if( millis()-aoapps_runled_anim_ms < AOAPPS_RUNLED_ANIM_MS ) return aoresult_ok; 
-  aoapps_runled_anim_ms = millis();
-
-  // Update: set triplet tix to color cix
-  result= aomw_topo_settriplet(aoapps_runled_anim_tix, aoapps_runled_anim_rgbs[aoapps_runled_anim_colorix] );
+// Paints the cursor position and advances the cursor (one LED)
+static aoresult_t aoapps_runled_anim_advance() {
+  // Update: set triplet tix to color cix (the shadow skips it when it already has that color)
+  aoresult_t result= aoapps_frame_set(aoapps_runled_anim_tix, aoapps_runled_anim_rgbs[aoapps_runled_anim_colorix] );
   if( result!=aoresult_ok ) return result;
 
   // Go to next triplet
@@ -88,6 +85,7 @@ static aoresult_t aoapps_runled_anim() {
   } else  { // hit either end
     // reverse direction and step color
     aoapps_runled_anim_dir = -aoapps_runled_anim_dir;
+    aoapps_runled_anim_bounced= 1;
     aoapps_runled_anim_colorix += 1;
     if( aoapps_runled_anim_colorix==AOAPPS_RUNLED_RGBS_SIZE ) {
       aoapps_runled_anim_colorix= 0;
@@ -97,27 +95,63 @@ static aoresult_t aoapps_runled_anim() {
 }
 
 
+// Step of the runled state machine
+static aoresult_t aoapps_runled_anim() {
+  aoresult_t result;
+  
+  // How many cursor advances are due (since the previous one)
+  uint32_t due= (millis()-aoapps_runled_anim_ms) / AOAPPS_RUNLED_ANIM_MS;
+  if( due==0 ) return aoresult_ok; 
+  // Advance the time stamp by the due steps (not to now), so that no time is lost
+  aoapps_runled_anim_ms += due * AOAPPS_RUNLED_ANIM_MS;
+  // When far behind (a full sweep), give up catching up
+  if( due > (uint32_t)aomw_topo_numtriplets() ) {
+    due= aomw_topo_numtriplets();
+    aoapps_runled_anim_ms = millis();
+  }
+
+  // Advance cursor `due` times, and paint the result in one batch
+  for( uint32_t i=0; i<due; i++ ) {
+    result= aoapps_runled_anim_advance();
+    if( result!=aoresult_ok ) return result;
+  }
+  result= aoapps_frame_commit();
+  if( result!=aoresult_ok ) return result;
+  aoapps_mngr_stats_frame();
+
+  return aoresult_ok;
+}
+
+
+// Paints all triplets from the state of the cursor (used to resume)
+static aoresult_t aoapps_runled_anim_repaint() {
+  static const aomw_topo_rgb_t black= { 0, 0, 0, "black" };
+  int previx= (aoapps_runled_anim_colorix+AOAPPS_RUNLED_RGBS_SIZE-1) % AOAPPS_RUNLED_RGBS_SIZE;
+  const aomw_topo_rgb_t * prev= aoapps_runled_anim_bounced ? aoapps_runled_anim_rgbs[previx] : &black;
+  for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
+    // Triplets the cursor passed have the current color, the others still have the previous color
+    int passed= aoapps_runled_anim_dir>0 ? tix<aoapps_runled_anim_tix : tix>aoapps_runled_anim_tix;
+    aoresult_t result= aoapps_frame_set(tix, passed ? aoapps_runled_anim_rgbs[aoapps_runled_anim_colorix] : prev );
+    if( result!=aoresult_ok ) return result;
+  }
+  return aoapps_frame_commit();
+}
+
+
 // === Button ================================================================
 
 
 #define AOAPPS_RUNLED_BUTTONS_PERKIBI 256 // if macro has value x, num steps is approx log(1024)/log(1+x/1024)
-#define AOAPPS_RUNLED_BUTTONS_MS      200 // step interval (in ms) for auto dim
 
 
-// Handling button presses (to dim down/up)
-static uint32_t aoapps_runled_buttons_ms;
-static aoresult_t aoapps_runled_buttons_check() {
-  if( aoui32_but_wentdown(AOUI32_BUT_X | AOUI32_BUT_Y) ) {
-    aoapps_runled_buttons_ms = millis()-AOAPPS_RUNLED_BUTTONS_MS; // spoof time
-  }
-  if( aoui32_but_isdown(AOUI32_BUT_X | AOUI32_BUT_Y) && millis()-aoapps_runled_buttons_ms> AOAPPS_RUNLED_BUTTONS_MS) {
-    aoapps_runled_buttons_ms = millis();
-    int dim= aomw_topo_dim_get();
-    int step= dim*AOAPPS_RUNLED_BUTTONS_PERKIBI/1024 +1; // +1 ensures step is not 0
-    if( aoui32_but_isdown(AOUI32_BUT_X) ) dim-=step; else dim+=step;
-    aomw_topo_dim_set(dim); // function clips (no need to do that here)
-    // Serial.printf("dim %d\n", aomw_topo_dim_get());
-  }
+// Handles X/Y button events from the manager (to dim down/up; press and repeats while held)
+static aoresult_t aoapps_runled_on_button(int but, int event) {
+  if( event==AOAPPS_MNGR_BUTTON_RELEASE ) return aoresult_ok;
+  int dim= aomw_topo_dim_get();
+  int step= dim*AOAPPS_RUNLED_BUTTONS_PERKIBI/1024 +1; // +1 ensures step is not 0
+  if( but==AOUI32_BUT_X ) dim-=step; else dim+=step;
+  aomw_topo_dim_set(dim); // function clips (no need to do that here)
+  // Serial.printf("dim %d\n", aomw_topo_dim_get());
   return aoresult_ok;
 }
 
@@ -127,6 +161,8 @@ static aoresult_t aoapps_runled_buttons_check() {
 
 // save the topo global dim level
 static int aoapps_runled_dimdft; 
+// save the dim level of this app (while suspended)
+static int aoapps_runled_dimapp; 
 
 
 // The application manager entry point (start)
@@ -134,9 +170,10 @@ aoresult_t aoapps_runled_start() {
   aoapps_runled_anim_tix= 0;
   aoapps_runled_anim_colorix= 0;
   aoapps_runled_anim_dir= +1;
+  aoapps_runled_anim_bounced= 0;
   aoapps_runled_anim_ms= millis();
-  aoapps_runled_buttons_ms= millis();
   aoapps_runled_dimdft= aomw_topo_dim_get();
+  aoapps_frame_reset();
   return aoresult_ok;
 }
 
@@ -144,12 +181,11 @@ aoresult_t aoapps_runled_start() {
 // The application manager entry point (step)
 aoresult_t aoapps_runled_step() {
   aoresult_t result;
-  // check ui32 buttons
-  result= aoapps_runled_buttons_check();
-  if( result!=aoresult_ok ) return result;
-  // actual animation
+  // actual animation (buttons are handled by aoapps_runled_on_button)
   result = aoapps_runled_anim();
   if( result!=aoresult_ok ) return result;
+  // tell the manager when the next cursor advance is due
+  aoapps_mngr_wakeup_at(aoapps_runled_anim_ms+AOAPPS_RUNLED_ANIM_MS);
   // return success
   return aoresult_ok;
 }
@@ -162,9 +198,41 @@ void aoapps_runled_stop() {
 }
 
 
+// The application manager entry point (suspend)
+void aoapps_runled_suspend() {
+  // keep own dim level, restore original dim level
+  aoapps_runled_dimapp= aomw_topo_dim_get();
+  aomw_topo_dim_set(aoapps_runled_dimdft);
+}
+
+
+// The application manager entry point (resume)
+aoresult_t aoapps_runled_resume() {
+  aoapps_runled_dimdft= aomw_topo_dim_get();
+  aomw_topo_dim_set(aoapps_runled_dimapp);
+  // continue where the cursor was (no catching up on the suspended time)
+  aoapps_runled_anim_ms= millis();
+  // other apps have painted the chain
+  aoapps_frame_reset();
+  return aoapps_runled_anim_repaint();
+}
+
+
 // === Registration ==========================================================
 
 
+// The descriptor of the runled app (constexpr: checked at compile time, stored in flash)
+static constexpr aoapps_mngr_app_t aoapps_runled_app= { 
+  "runled", "Running LEDs", "dim -", "dim +",
+  AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR,
+  aoapps_runled_start, aoapps_runled_step, aoapps_runled_stop,
+  0, 0 /* no config command */,
+  aoapps_runled_suspend, aoapps_runled_resume,
+  aoapps_runled_on_button
+};
+static_assert( aoapps_mngr_app_ok(aoapps_runled_app), "runled descriptor" );
+
+
 /*!
     @brief  Registers the runled app with the app manager.
     @note   This app triplet-by-triplet fills the strip with a color,
@@ -174,10 +242,7 @@ void aoapps_runled_stop() {
             The OSP32 board would be enough.
 */
 void aoapps_runled_register() {
-  aoapps_mngr_register("runled", "Running LEDs", "dim -", "dim +", 
-    AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR, 
-    aoapps_runled_start, aoapps_runled_step, aoapps_runled_stop, 
-    0, 0 /* no config command */ );
+  aoapps_mngr_register_app(&aoapps_runled_app);
 }
 
 
@@ -31,6 +31,10 @@ aoresult_t aoapps_runled_start();
 aoresult_t aoapps_runled_step();
 // The application manager exit (stop) for runled
 void aoapps_runled_stop();
+// The application manager suspend (stop, but keep state) for runled
+void aoapps_runled_suspend();
+// The application manager resume (start from kept state) for runled
+aoresult_t aoapps_runled_resume();
 
 
 // Registers the "runled" app with the app manager.
@@ -22,7 +22,7 @@
 #include <aoresult.h>      // AORESULT_ASSERT, aoresult_t
 #include <aoosp.h>         // aoosp_send_clrerror()
 #include <aocmd.h>         // aocmd_cint_isprefix()
-#include <aoui32.h>        // aoui32_but_wentdown()
+#include <aoui32.h>        // AOUI32_BUT_X
 #include <aomw.h>          // aomw_topo_build_start()
 #include <aoapps_mngr.h>   // aoapps_mngr_register
 #include <aoapps_swflag.h> // own
@@ -44,13 +44,82 @@ BUTTONS
 
 NOTES
 - When the app quits, the indicator LED switches off
+- When the app is resumed, it does not search the I/O-expander again, it repaints the flag it showed
+- A flag is only sent to the chain when it differs from what the chain shows (other flag or dim level),
+  so a held dim button at its limit, or a button for the flag already shown, costs no telegrams
+- Dimming repaints at most every AOAPPS_SWFLAG_BUTTONS_MS, and less often on long chains
+  (repaints take at most 1/AOAPPS_SWFLAG_BUTTONS_BUSDIV of the time; a repaint then covers more dim steps)
 - This app adds a command to configure which four flags will be shown
+- Every IOX button scan is an OSP->SAID->I2C round trip, so the buttons are not scanned every step:
+  fast (AOAPPS_SWFLAG_SCAN_FASTMS) while a button is down or shortly after a press,
+  slow (AOAPPS_SWFLAG_SCAN_SLOWMS) when idle; "apps config swflag scan" configures and reports
+- A press (down and up) shorter than the slow scan interval falls between two scans when idle,
+  and is missed; lower the slow interval if that matters
 
 GOAL
 - To show a "sensor" (button) being accessible from the root MCU (the ESP)
 */
 
 
+// === IOX button scanning ===================================================
+// Scanning the I/O-expander buttons is an OSP->SAID->I2C round trip, so 
+// buttons are scanned at a rate, not every step: fast while a button is 
+// down and for a while after a press, slow when idle.
+
+
+#define AOAPPS_SWFLAG_SCAN_FASTMS   20   // default scan interval (in ms) when buttons are active
+#define AOAPPS_SWFLAG_SCAN_SLOWMS   100  // default scan interval (in ms) when buttons are idle
+#define AOAPPS_SWFLAG_SCAN_ACTIVEMS 2000 // buttons are active this long (in ms) after a press
+
+
+static int      aoapps_swflag_scan_fastms= AOAPPS_SWFLAG_SCAN_FASTMS; // configured scan interval (in ms) when active
+static int      aoapps_swflag_scan_slowms= AOAPPS_SWFLAG_SCAN_SLOWMS; // configured scan interval (in ms) when idle
+static uint32_t aoapps_swflag_scan_lastms;  // time stamp (in ms) of last scan
+static uint32_t aoapps_swflag_scan_pressms; // time stamp (in ms) of last scan that found a button down
+// Statistics
+static uint32_t aoapps_swflag_scan_scans;   // number of scans
+static uint32_t aoapps_swflag_scan_skips;   // number of steps that did not scan (before, each step scanned)
+static uint64_t aoapps_swflag_scan_sumus;   // total duration of all scans (in us)
+
+
+// Returns the current scan interval (in ms): fast when buttons are active, otherwise slow.
+static int aoapps_swflag_scan_intervalms() {
+  if( millis()-aoapps_swflag_scan_pressms < AOAPPS_SWFLAG_SCAN_ACTIVEMS ) return aoapps_swflag_scan_fastms;
+  return aoapps_swflag_scan_slowms;
+}
+
+
+// Returns the time stamp (in ms) the next scan is due.
+static uint32_t aoapps_swflag_scan_duems() {
+  return aoapps_swflag_scan_lastms + aoapps_swflag_scan_intervalms();
+}
+
+
+// Resets the scan scheduler (and statistics), so that the next step scans.
+static void aoapps_swflag_scan_reset() {
+  aoapps_swflag_scan_lastms= millis() - aoapps_swflag_scan_slowms;
+  aoapps_swflag_scan_pressms= millis() - AOAPPS_SWFLAG_SCAN_ACTIVEMS;
+  aoapps_swflag_scan_scans= 0;
+  aoapps_swflag_scan_skips= 0;
+  aoapps_swflag_scan_sumus= 0;
+}
+
+
+// Scans the IOX buttons when the scan is due; `*scanned` tells if it did.
+static aoresult_t aoapps_swflag_scan(int * scanned) {
+  *scanned= (int32_t)(millis()-aoapps_swflag_scan_duems()) >= 0;
+  if( !*scanned ) { aoapps_swflag_scan_skips++; return aoresult_ok; }
+  uint32_t us0= micros();
+  aoresult_t result= aomw_iox_but_scan();
+  aoapps_swflag_scan_sumus+= micros()-us0;
+  aoapps_swflag_scan_scans++;
+  aoapps_swflag_scan_lastms= millis();
+  if( result!=aoresult_ok ) return result;
+  if( aomw_iox_but_isdown(AOMW_IOX_BUT0|AOMW_IOX_BUT1|AOMW_IOX_BUT2|AOMW_IOX_BUT3) ) aoapps_swflag_scan_pressms= millis();
+  return aoresult_ok;
+}
+
+
 // === Animation state machine ===============================================
 
 
@@ -70,6 +139,35 @@ static int      aoapps_swflag_anim_flagix;     // index of flag being shown
 static uint32_t aoapps_swflag_anim_lastms;     // last time stamp (in ms) a flag was shown (for auto change)
 
 
+// What the OSP chain shows, so that an unchanged frame is not sent again
+static int      aoapps_swflag_shown_pix= -1;   // painter index of the flag on the chain (-1 when unknown)
+static int      aoapps_swflag_shown_dim;       // dim level the flag on the chain was painted with
+static uint32_t aoapps_swflag_shown_us;        // duration (in us) of the last paint that was sent
+
+
+// Forgets what the OSP chain shows (e.g. another app painted it), so that the next paint is sent.
+static void aoapps_swflag_shown_forget() {
+  aoapps_swflag_shown_pix= -1;
+}
+
+
+// Paints the selected flag, unless the chain already shows that flag at the current dim level.
+static aoresult_t aoapps_swflag_paint() {
+  int pix= aomw_swflags_anim_pix[aoapps_swflag_anim_flagix];
+  int dim= aomw_topo_dim_get();
+  if( pix==aoapps_swflag_shown_pix && dim==aoapps_swflag_shown_dim ) return aoresult_ok;
+  aoapps_swflag_shown_forget(); // in case painting fails half way
+  uint32_t us0= micros();
+  aoresult_t result= aomw_flag_painter(pix)();
+  if( result!=aoresult_ok ) return result;
+  aoapps_swflag_shown_us= micros()-us0;
+  aoapps_swflag_shown_pix= pix;
+  aoapps_swflag_shown_dim= dim;
+  aoapps_mngr_stats_frame();
+  return aoresult_ok;
+}
+
+
 // Step of the swflag state machine
 static aoresult_t aoapps_swflag_anim() {
   aoresult_t result;
@@ -77,13 +175,16 @@ static aoresult_t aoapps_swflag_anim() {
   // New flag to display? Record that in flagix
   int flagix= aoapps_swflag_anim_flagix;
   if( aoapps_swflag_anim_ioxpresent ) {
-    // IOX present: switch flags when button is pressed
-    result= aomw_iox_but_scan();
+    // IOX present: switch flags when button is pressed (buttons are scanned at a rate)
+    int scanned;
+    result= aoapps_swflag_scan(&scanned);
     if( result!=aoresult_ok ) return result;
-    if( aomw_iox_but_wentdown(AOMW_IOX_BUT0) ) flagix=0;
-    if( aomw_iox_but_wentdown(AOMW_IOX_BUT1) ) flagix=1;
-    if( aomw_iox_but_wentdown(AOMW_IOX_BUT2) ) flagix=2;
-    if( aomw_iox_but_wentdown(AOMW_IOX_BUT3) ) flagix=3;
+    if( scanned ) {
+      if( aomw_iox_but_wentdown(AOMW_IOX_BUT0) ) flagix=0;
+      if( aomw_iox_but_wentdown(AOMW_IOX_BUT1) ) flagix=1;
+      if( aomw_iox_but_wentdown(AOMW_IOX_BUT2) ) flagix=2;
+      if( aomw_iox_but_wentdown(AOMW_IOX_BUT3) ) flagix=3;
+    }
   } else {
     // IOX absent: switch flags every AOAPPS_SWFLAG_ANIM_MS
     if( millis()-aoapps_swflag_anim_lastms > AOAPPS_SWFLAG_ANIM_MS ) {
@@ -92,13 +193,16 @@ static aoresult_t aoapps_swflag_anim() {
     }
   }
 
-  // Different flag selected? Paint it
-  if( aoapps_swflag_anim_flagix!=flagix ) {
-    aoapps_swflag_anim_flagix = flagix;
-    // Paint the flag 
-    result= aomw_flag_painter(aomw_swflags_anim_pix[aoapps_swflag_anim_flagix])();
+  // Paint the selected flag when it differs from what is shown (e.g. after 'apps config swflag set'); dim changes are repainted by aoapps_swflag_buttons_repaint()
+  int changed= aoapps_swflag_anim_flagix!=flagix;
+  aoapps_swflag_anim_flagix = flagix;
+  if( aomw_swflags_anim_pix[aoapps_swflag_anim_flagix]!=aoapps_swflag_shown_pix ) {
+    result= aoapps_swflag_paint();
     if( result!=aoresult_ok ) return result;
-    // Highlight the associated indicator LED
+  }
+
+  // Different flag selected? Highlight the associated indicator LED
+  if( changed ) {
     if( aoapps_swflag_anim_ioxpresent ) {
       result= aomw_iox_led_set( AOMW_IOX_LED(aoapps_swflag_anim_flagix) ); 
       if( result!=aoresult_ok ) return result;
@@ -113,32 +217,52 @@ static aoresult_t aoapps_swflag_anim() {
 
 
 #define AOAPPS_SWFLAG_BUTTONS_PERKIBI 256 // if macro has value x, num steps is approx log(1024)/log(1+x/1024)
-#define AOAPPS_SWFLAG_BUTTONS_MS      200 // step interval (in ms) for auto dim
+#define AOAPPS_SWFLAG_BUTTONS_MS      200 // minimal interval (in ms) between two repaints for dimming
+#define AOAPPS_SWFLAG_BUTTONS_BUSDIV  10  // while dimming, repaints use at most 1/x of the time
+
+
+// Handles X/Y button events from the manager (to dim down/up; press and repeats while held).
+// Only the dim level is changed, aoapps_swflag_buttons_repaint() repaints.
+static aoresult_t aoapps_swflag_on_button(int but, int event) {
+  if( event==AOAPPS_MNGR_BUTTON_RELEASE ) return aoresult_ok;
+  int dim= aomw_topo_dim_get();
+  int step= dim*AOAPPS_SWFLAG_BUTTONS_PERKIBI/1024 +1; // +1 ensures step is not 0
+  if( but==AOUI32_BUT_X ) dim-=step; else dim+=step;
+  aomw_topo_dim_set(dim); // function clips (no need to do that here)
+  // Serial.printf("dim %d\n", aomw_topo_dim_get());
+  return aoresult_ok;
+}
 
 
-// Handling button presses (to dim down/up)
-static uint32_t aoapps_swflag_buttons_ms;
-static aoresult_t aoapps_swflag_buttons_check() {
-  if( aoui32_but_wentdown(AOUI32_BUT_X | AOUI32_BUT_Y) ) {
-    aoapps_swflag_buttons_ms = millis()-AOAPPS_SWFLAG_BUTTONS_MS; // spoof time
-  }
-  if( aoui32_but_isdown(AOUI32_BUT_X | AOUI32_BUT_Y) && millis()-aoapps_swflag_buttons_ms> AOAPPS_SWFLAG_BUTTONS_MS) {
-    aoapps_swflag_buttons_ms = millis();
-    int dim= aomw_topo_dim_get();
-    int step= dim*AOAPPS_SWFLAG_BUTTONS_PERKIBI/1024 +1; // +1 ensures step is not 0
-    if( aoui32_but_isdown(AOUI32_BUT_X) ) dim-=step; else dim+=step;
-    aomw_topo_dim_set(dim); // function clips (no need to do that here)
-    // Serial.printf("dim %d\n", aomw_topo_dim_get());
-    // Repaint the flag 
-    aoresult_t result= aomw_flag_painter(aomw_swflags_anim_pix[aoapps_swflag_anim_flagix])();
-    if( result!=aoresult_ok ) return result;
-  }
-  return aoresult_ok;
+// Every dim change repaints the whole flag (the painters are in aomw). On long
+// chains that would flood the bus, so the interval grows with the duration 
+// of a paint; dim steps in between are combined in one repaint (same dim speed).
+static uint32_t aoapps_swflag_buttons_intervalms() {
+  uint32_t ms= aoapps_swflag_shown_us * AOAPPS_SWFLAG_BUTTONS_BUSDIV / 1000;
+  if( ms<AOAPPS_SWFLAG_BUTTONS_MS ) ms= AOAPPS_SWFLAG_BUTTONS_MS;
+  return ms;
+}
+
+
+// Returns 1 iff the dim level changed since the flag was painted (a repaint is pending)
+static int aoapps_swflag_buttons_pending() {
+  return aoapps_swflag_shown_pix>=0 && aoapps_swflag_shown_dim!=aomw_topo_dim_get();
+}
+
+
+// Repaints the flag when the dim level changed, but not more often than every aoapps_swflag_buttons_intervalms()
+static uint32_t aoapps_swflag_buttons_ms; // time stamp (in ms) of last repaint for dimming
+static aoresult_t aoapps_swflag_buttons_repaint() {
+  if( !aoapps_swflag_buttons_pending() ) return aoresult_ok;
+  if( millis()-aoapps_swflag_buttons_ms < aoapps_swflag_buttons_intervalms() ) return aoresult_ok;
+  aoapps_swflag_buttons_ms= millis();
+  return aoapps_swflag_paint();
 }
 
 
 // === Configuration handler =================================================
-// This application actually has a configuration option: which flags to show
+// This application actually has configuration options: which flags to show,
+// and the rate at which the IOX buttons are scanned
 
 
 // Lookup the named `flag` in the list of flags aomw_flag_name().
@@ -160,6 +284,16 @@ static void aoapps_swflag_cmd_show( ) {
 }
 
 
+// Show on Serial the scan rates and the scan statistics
+static void aoapps_swflag_cmd_scanshow( ) {
+  Serial.printf("scan: fast %d ms, slow %d ms\n", aoapps_swflag_scan_fastms, aoapps_swflag_scan_slowms );
+  uint32_t meanus= aoapps_swflag_scan_scans==0 ? 0 : aoapps_swflag_scan_sumus / aoapps_swflag_scan_scans;
+  Serial.printf("scans %lu (mean %lu us), skipped %lu (saved %lu ms bus time)\n", 
+    (unsigned long)aoapps_swflag_scan_scans, (unsigned long)meanus,
+    (unsigned long)aoapps_swflag_scan_skips, (unsigned long)((uint64_t)aoapps_swflag_scan_skips*meanus/1000) );
+}
+
+
 // The handler for the "apps config swflags" command
 static void aoapps_swflag_cmd_main( int argc, char * argv[] ) {
   AORESULT_ASSERT( argc>3 );
@@ -183,6 +317,18 @@ static void aoapps_swflag_cmd_main( int argc, char * argv[] ) {
       aomw_swflags_anim_pix[flagix]= aoapps_swflag_cmd_find(argv[4+flagix]);
     if( argv[0][0]!='@' ) aoapps_swflag_cmd_show();
     return;
+  } else if( aocmd_cint_isprefix("scan",argv[3]) ) {
+    if( argc!=4 && argc!=6 ) { Serial.printf("ERROR: 'swflags' expects <fastms> <slowms>\n" ); return; }
+    if( argc==6 ) {
+      int fastms, slowms;
+      if( !aocmd_cint_parse_dec(argv[4],&fastms) || fastms<1 || fastms>10000 ) { Serial.printf("ERROR: 'swflags' expects <fastms> 1..10000, not '%s'\n", argv[4] ); return; }
+      if( !aocmd_cint_parse_dec(argv[5],&slowms) || slowms<1 || slowms>10000 ) { Serial.printf("ERROR: 'swflags' expects <slowms> 1..10000, not '%s'\n", argv[5] ); return; }
+      aoapps_swflag_scan_fastms= fastms;
+      aoapps_swflag_scan_slowms= slowms;
+      if( argv[0][0]=='@' ) return;
+    }
+    aoapps_swflag_cmd_scanshow();
+    return;
   } else {
     Serial.printf("ERROR: 'swflags' has unknown argument (%s)\n",argv[3] ); return;
   }
@@ -197,6 +343,9 @@ static const char aoapps_swflag_cmd_help[] =
   "- shows configured flags\n"
   "SYNTAX: apps config swflag set <flag1> <flag2> <flag3> <flag4>\n"
   "- configures four flags (from list)\n"
+  "SYNTAX: apps config swflag scan [ <fastms> <slowms> ]\n"
+  "- optionally configures the I/O-expander button scan interval when buttons\n"
+  "  are active (fast) or idle (slow), shows scans and bus time saved\n"
 ;
 
 
@@ -209,6 +358,8 @@ static const char aoapps_swflag_cmd_help[] =
 
 // save the topo global dim level
 static int aoapps_swflag_dimdft; 
+// save the dim level of this app (while suspended)
+static int aoapps_swflag_dimapp; 
 
 
 // The application manager entry point (start)
@@ -225,14 +376,16 @@ static aoresult_t aoapps_swflag_start() {
     Serial.printf("swflags: using I/O-expander %02x on SAID %03x \n",AOMW_IOX_DADDR7,addr);
     result= aomw_iox_init( addr ); 
     if( result!=aoresult_ok ) return result;
+    aoapps_swflag_scan_reset();
   } else {
     Serial.printf("swflags: no I/O-expander found, cycling flags\n");
   }
   
   // Select first flag
   aoapps_swflag_anim_flagix= 0;
-  // Paint the selected flag 
-  result= aomw_flag_painter(aomw_swflags_anim_pix[aoapps_swflag_anim_flagix])(); 
+  // Paint the selected flag (the chain shows whatever the previous app painted)
+  aoapps_swflag_shown_forget();
+  result= aoapps_swflag_paint(); 
   if( result!=aoresult_ok ) return result;
   // Highlight the associated indicator LED
   if( aoapps_swflag_anim_ioxpresent ) {
@@ -252,12 +405,16 @@ static aoresult_t aoapps_swflag_start() {
 // The application manager entry point (step)
 static aoresult_t aoapps_swflag_step() {
   aoresult_t result;
-  // check ui32 buttons
-  result= aoapps_swflag_buttons_check();
+  // repaint for a new dim level (buttons are handled by aoapps_swflag_on_button)
+  result= aoapps_swflag_buttons_repaint();
   if( result!=aoresult_ok ) return result;
   // actual animation
   result= aoapps_swflag_anim();
   if( result!=aoresult_ok ) return result;
+  // tell the manager when the next dim repaint, button scan (with IOX) or flag (without) is due
+  if( aoapps_swflag_buttons_pending() ) aoapps_mngr_wakeup_at(aoapps_swflag_buttons_ms+aoapps_swflag_buttons_intervalms());
+  else if( aoapps_swflag_anim_ioxpresent ) aoapps_mngr_wakeup_at(aoapps_swflag_scan_duems());
+  else aoapps_mngr_wakeup_at(aoapps_swflag_anim_lastms+AOAPPS_SWFLAG_ANIM_MS+1);
   // return success
   return aoresult_ok;
 }
@@ -272,9 +429,52 @@ static void aoapps_swflag_stop() {
 }
 
 
+// The application manager entry point (suspend)
+static void aoapps_swflag_suspend() {
+  // Shut down indicator LEDs
+  aomw_iox_led_set( AOMW_IOX_LEDNONE );
+  // keep own dim level, restore original dim level
+  aoapps_swflag_dimapp= aomw_topo_dim_get();
+  aomw_topo_dim_set(aoapps_swflag_dimdft);
+}
+
+
+// The application manager entry point (resume)
+static aoresult_t aoapps_swflag_resume() {
+  aoresult_t result;
+  // Restore own dim level
+  aoapps_swflag_dimdft= aomw_topo_dim_get();
+  aomw_topo_dim_set(aoapps_swflag_dimapp);
+  // Repaint the selected flag (I/O-expander was found and initialized by start)
+  aoapps_swflag_shown_forget();
+  result= aoapps_swflag_paint(); 
+  if( result!=aoresult_ok ) return result;
+  // Highlight the associated indicator LED
+  if( aoapps_swflag_anim_ioxpresent ) {
+    result= aomw_iox_led_set( AOMW_IOX_LED(aoapps_swflag_anim_flagix) ); 
+    if( result!=aoresult_ok ) return result;
+  }
+  // Record time stamp of painting
+  aoapps_swflag_anim_lastms= millis();
+  return aoresult_ok;
+}
+
+
 // === Registration ==========================================================
 
 
+// The descriptor of the swflag app (constexpr: checked at compile time, stored in flash)
+static constexpr aoapps_mngr_app_t aoapps_swflag_app= { 
+  "swflag", "Switch flag", "dim -", "dim +",
+  AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR,
+  aoapps_swflag_start, aoapps_swflag_step, aoapps_swflag_stop,
+  aoapps_swflag_cmd_main, aoapps_swflag_cmd_help,
+  aoapps_swflag_suspend, aoapps_swflag_resume,
+  aoapps_swflag_on_button
+};
+static_assert( aoapps_mngr_app_ok(aoapps_swflag_app), "swflag descriptor" );
+
+
 /*!
     @brief  Registers the swflag app with the app manager.
     @note   This app shows one of four flags on the OSP chain.
@@ -286,10 +486,7 @@ static void aoapps_swflag_stop() {
     @note   A typical board to use is the SAIDbasic demo board.
 */
 void aoapps_swflag_register() {
-  aoapps_mngr_register("swflag", "Switch flag", "dim -", "dim +", 
-    AOAPPS_MNGR_FLAGS_WITHTOPO | AOAPPS_MNGR_FLAGS_WITHREPAIR,  
-    aoapps_swflag_start, aoapps_swflag_step, aoapps_swflag_stop, 
-    aoapps_swflag_cmd_main, aoapps_swflag_cmd_help );
+  aoapps_mngr_register_app(&aoapps_swflag_app);
 }
 
 